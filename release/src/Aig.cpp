@@ -0,0 +1,138 @@
+#include "Aig.hpp"
+#include "NetlistGraph.hpp"
+#include <algorithm>
+
+const uint32_t Aig::kFalse;
+const uint32_t Aig::kTrue;
+const uint32_t Aig::kNoFanin;
+
+Aig::Aig() : fanins(2, kNoFanin), inputPositions(1, 0), inputCount(0) {}
+
+uint32_t Aig::addInput() {
+    uint32_t node = static_cast<uint32_t>(numNodes());
+    fanins.push_back(kNoFanin);
+    fanins.push_back(kNoFanin);
+    inputPositions.push_back(static_cast<uint32_t>(inputCount++));
+    return 2 * node;
+}
+
+uint32_t Aig::makeAnd(uint32_t a, uint32_t b) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    if (a == kFalse || a == (b ^ 1)) {
+        return kFalse;
+    }
+    if (a == kTrue || a == b) {
+        return b;
+    }
+    uint64_t key = static_cast<uint64_t>(a) << 32 | b;
+    auto it = strash.find(key);
+    if (it != strash.end()) {
+        return 2 * it->second;
+    }
+    uint32_t node = static_cast<uint32_t>(numNodes());
+    fanins.push_back(a);
+    fanins.push_back(b);
+    inputPositions.push_back(0);
+    strash.emplace(key, node);
+    return 2 * node;
+}
+
+uint32_t Aig::makeOr(uint32_t a, uint32_t b) {
+    return makeAnd(a ^ 1, b ^ 1) ^ 1;
+}
+
+uint32_t Aig::makeXor(uint32_t a, uint32_t b) {
+    return makeOr(makeAnd(a, b ^ 1), makeAnd(a ^ 1, b));
+}
+
+bool Aig::addNetlist(const Netlist& netlist, const std::vector<GateFunction>& functions, const std::vector<uint32_t>& inputs,
+                     std::vector<uint32_t>& outputs, std::string& error) {
+    std::unordered_map<std::string, uint32_t> nets;
+    nets["1'b0"] = kFalse;
+    nets["1'b1"] = kTrue;
+    for (size_t i = 0; i < netlist.inputs.size() && i < inputs.size(); ++i) {
+        nets[netlist.inputs[i]] = inputs[i];
+    }
+    std::unordered_map<std::string, size_t> drivers;
+    for (size_t index = 0; index < netlist.gates.size(); ++index) {
+        drivers[netlist.gates[index].output] = index;
+    }
+    auto lookup = [&](const std::string& name, uint32_t& literal) {
+        auto it = nets.find(name);
+        if (it != nets.end()) {
+            literal = it->second;
+            return true;
+        }
+        literal = kFalse;
+        return drivers.find(name) == drivers.end();
+    };
+
+    NetlistGraph graph(netlist);
+    for (size_t index : graph.order()) {
+        const Gate& gate = netlist.gates[index];
+        GateFunction function = index < functions.size() ? functions[index] : gateFunction(gate.type);
+        if (function == GATE_UNKNOWN) {
+            error = "Unsupported gate type " + gate.type + " of gate " + gate.name;
+            return false;
+        }
+        std::vector<uint32_t> literals(gate.inputs.size());
+        for (size_t k = 0; k < gate.inputs.size(); ++k) {
+            if (!lookup(gate.inputs[k], literals[k])) {
+                error = "Combinational loop through gate " + gate.name;
+                return false;
+            }
+        }
+        // Same conventions as the simulator: single inputs pass through and wider gates fold pairwise
+        uint32_t result = kFalse;
+        if (!literals.empty()) {
+            result = literals[0];
+            for (size_t k = 1; k < literals.size(); ++k) {
+                if (function == GATE_OR || function == GATE_NOR) {
+                    result = makeOr(result, literals[k]);
+                } else if (function == GATE_XOR || function == GATE_XNOR) {
+                    result = makeXor(result, literals[k]);
+                } else {
+                    result = makeAnd(result, literals[k]);
+                }
+            }
+            if (function == GATE_NAND || function == GATE_NOR || function == GATE_XNOR || function == GATE_NOT) {
+                result ^= 1;
+            }
+        }
+        nets[gate.output] = result;
+    }
+
+    outputs.clear();
+    for (const auto& output : netlist.outputs) {
+        uint32_t literal;
+        lookup(output, literal);
+        outputs.push_back(literal);
+    }
+    return true;
+}
+
+size_t Aig::numNodes() const {
+    return fanins.size() / 2;
+}
+
+size_t Aig::numInputs() const {
+    return inputCount;
+}
+
+bool Aig::isInput(uint32_t node) const {
+    return node != 0 && fanins[2 * node] == kNoFanin;
+}
+
+size_t Aig::inputIndex(uint32_t node) const {
+    return inputPositions[node];
+}
+
+uint32_t Aig::fanin0(uint32_t node) const {
+    return fanins[2 * node];
+}
+
+uint32_t Aig::fanin1(uint32_t node) const {
+    return fanins[2 * node + 1];
+}
@@ -0,0 +1,51 @@
+#ifndef AIG_HPP
+#define AIG_HPP
+
+#include "LogicSimulator.hpp"
+#include "NetlistParser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// And-inverter graph: every node is a primary input or a two-input AND, and edges may be inverted.
+// A literal is 2 * node + 1 if inverted; node 0 is the constant 0, so literal 0 is false and 1 true.
+// Nodes are created after their fanins, so node order is a topological order. Structural hashing
+// returns the existing node for an AND of the same fanins, and trivial ANDs fold to a fanin or constant.
+class Aig {
+public:
+    static const uint32_t kFalse = 0;
+    static const uint32_t kTrue = 1;
+
+    Aig();
+
+    uint32_t addInput();
+    uint32_t makeAnd(uint32_t a, uint32_t b);
+    uint32_t makeOr(uint32_t a, uint32_t b);
+    uint32_t makeXor(uint32_t a, uint32_t b);
+
+    // Add the gates of a netlist on top of the given literals of its primary inputs, in declaration
+    // order, and return the literals of its primary outputs. Gate functions are given per gate or taken
+    // from the gate types; undriven nets read as 0. Returns false with a message for unsupported gates
+    // and combinational loops.
+    bool addNetlist(const Netlist& netlist, const std::vector<GateFunction>& functions, const std::vector<uint32_t>& inputs,
+                    std::vector<uint32_t>& outputs, std::string& error);
+
+    size_t numNodes() const;
+    size_t numInputs() const;
+    bool isInput(uint32_t node) const;
+    size_t inputIndex(uint32_t node) const;  // Position among the inputs, for input nodes
+    uint32_t fanin0(uint32_t node) const;    // Fanin literals, for AND nodes
+    uint32_t fanin1(uint32_t node) const;
+
+private:
+    static const uint32_t kNoFanin = ~0u;
+
+    std::vector<uint32_t> fanins;  // Two per node, kNoFanin for inputs and the constant
+    std::vector<uint32_t> inputPositions;
+    size_t inputCount;
+    std::unordered_map<uint64_t, uint32_t> strash;
+};
+
+#endif // AIG_HPP
@@ -0,0 +1,169 @@
+#include "BatchMoveSearch.hpp"
+#include <algorithm>
+#include <limits>
+
+static const size_t kCommitLevels = 5;  // Prefixes of the improving moves tried per round: all, 1/2, 1/4, ...
+
+BatchMoveSearch::BatchMoveSearch(const CellTable& cellTable, const BatchEvaluator& evaluate, BatchDesign design, size_t movesPerRound)
+    : cellTable(cellTable), evaluate(evaluate), design(design), movesPerRound(std::max<size_t>(movesPerRound, 1)),
+      evaluationCount(0), committedCount(0) {
+    for (size_t i = 0; i < cellTable.numGates(); ++i) {
+        if (cellTable.candidates(i).size() > 1) {
+            movableGates.push_back(i);
+        }
+    }
+}
+
+size_t BatchMoveSearch::evaluations() const {
+    return evaluationCount;
+}
+
+size_t BatchMoveSearch::committedMoves() const {
+    return committedCount;
+}
+
+std::vector<CellMove> BatchMoveSearch::drawMoves(const CellAssignment& assignment, Random& random) const {
+    // Partial Fisher-Yates shuffle: distinct gates, so the moves of a round commute
+    std::vector<size_t> gates = movableGates;
+    size_t count = std::min(movesPerRound, gates.size());
+    std::vector<CellMove> moves;
+    for (size_t i = 0; i < count; ++i) {
+        std::swap(gates[i], gates[i + random.below(gates.size() - i)]);
+        size_t gate = gates[i];
+        const std::vector<uint16_t>& cells = cellTable.candidates(gate);
+        uint16_t oldCell = assignment[gate];
+        uint16_t newCell = cells[random.below(cells.size() - 1)];
+        if (newCell == oldCell) {
+            newCell = cells.back();
+        }
+        if (oldCell == kNoCell || newCell == oldCell) {
+            continue;
+        }
+        CellMove move;
+        move.gate = static_cast<uint32_t>(gate);
+        move.oldCell = oldCell;
+        move.newCell = newCell;
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+std::vector<std::vector<bool>> BatchMoveSearch::designRows(size_t numMoves, Random& random) const {
+    // Hadamard order: the smallest power of two above the number of moves, so column 0 (all rows
+    // equal) is left out and every move gets its own balanced column
+    size_t numRows = 1;
+    while (numRows <= numMoves) {
+        numRows <<= 1;
+    }
+    std::vector<std::vector<bool>> rows(numRows, std::vector<bool>(numMoves));
+    for (size_t r = 0; r < numRows; ++r) {
+        for (size_t m = 0; m < numMoves; ++m) {
+            if (design == BATCH_DESIGN_HADAMARD) {
+                size_t bits = r & (m + 1);
+                size_t parity = 0;
+                while (bits) {
+                    parity ^= bits & 1;
+                    bits >>= 1;
+                }
+                rows[r][m] = parity != 0;
+            } else {
+                rows[r][m] = (random.next() >> 63) != 0;
+            }
+        }
+    }
+    return rows;
+}
+
+bool BatchMoveSearch::round(CellAssignment& assignment, float& cost, Random& random) {
+    std::vector<CellMove> moves = drawMoves(assignment, random);
+    if (moves.empty()) {
+        return false;
+    }
+    std::vector<std::vector<bool>> rows = designRows(moves.size(), random);
+
+    std::vector<CellAssignment> experiment;
+    for (const auto& row : rows) {
+        CellAssignment trial = assignment;
+        for (size_t m = 0; m < moves.size(); ++m) {
+            if (row[m]) {
+                trial.apply(moves[m]);
+            }
+        }
+        experiment.push_back(trial);
+    }
+    std::vector<float> costs = evaluate(experiment);
+    evaluationCount += experiment.size();
+
+    // Main effect of each move; rows that failed to evaluate are left out
+    std::vector<std::pair<double, size_t>> effects;
+    float bestRowCost = std::numeric_limits<float>::max();
+    size_t bestRow = 0;
+    for (size_t m = 0; m < moves.size(); ++m) {
+        double withSum = 0.0, withoutSum = 0.0;
+        size_t withCount = 0, withoutCount = 0;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            if (costs[r] >= std::numeric_limits<float>::max()) {
+                continue;
+            }
+            if (rows[r][m]) {
+                withSum += costs[r];
+                withCount++;
+            } else {
+                withoutSum += costs[r];
+                withoutCount++;
+            }
+        }
+        if (withCount > 0 && withoutCount > 0) {
+            double effect = withSum / withCount - withoutSum / withoutCount;
+            if (effect < 0.0) {
+                effects.push_back(std::make_pair(effect, m));
+            }
+        }
+    }
+    for (size_t r = 0; r < rows.size(); ++r) {
+        if (costs[r] < bestRowCost) {
+            bestRowCost = costs[r];
+            bestRow = r;
+        }
+    }
+
+    // Commit the consensus: all improving moves, then ever stronger subsets of them
+    std::sort(effects.begin(), effects.end());
+    std::vector<CellAssignment> commits;
+    std::vector<size_t> commitSizes;
+    for (size_t level = 0, count = effects.size(); level < kCommitLevels && count > 0; ++level, count /= 2) {
+        CellAssignment trial = assignment;
+        for (size_t i = 0; i < count; ++i) {
+            trial.apply(moves[effects[i].second]);
+        }
+        commits.push_back(trial);
+        commitSizes.push_back(count);
+    }
+    std::vector<float> commitCosts = evaluate(commits);
+    evaluationCount += commits.size();
+
+    float newCost = cost;
+    size_t chosen = commits.size();
+    for (size_t c = 0; c < commits.size(); ++c) {
+        if (commitCosts[c] < newCost) {
+            newCost = commitCosts[c];
+            chosen = c;
+        }
+    }
+    // An experiment row can beat every committed subset, e.g. when the moves interact
+    if (bestRowCost < newCost) {
+        cost = bestRowCost;
+        assignment = experiment[bestRow];
+        for (size_t m = 0; m < moves.size(); ++m) {
+            committedCount += rows[bestRow][m] ? 1 : 0;
+        }
+        return true;
+    }
+    if (chosen < commits.size()) {
+        cost = newCost;
+        assignment = commits[chosen];
+        committedCount += commitSizes[chosen];
+        return true;
+    }
+    return false;
+}
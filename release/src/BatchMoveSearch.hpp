@@ -0,0 +1,42 @@
+#ifndef BATCH_MOVE_SEARCH_HPP
+#define BATCH_MOVE_SEARCH_HPP
+
+#include "CellAssignment.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <vector>
+
+enum BatchDesign {
+    BATCH_DESIGN_HADAMARD,  // Rows of a Sylvester Hadamard matrix: main effects are orthogonal
+    BATCH_DESIGN_RANDOM     // Every move joins every row with probability one half
+};
+
+// Group-testing search: each round draws a set of single-gate moves and evaluates a designed experiment
+// of assignments that apply about half of them each. The effect of every move is estimated as the
+// difference between the mean cost of the rows that apply it and the rows that do not, and the moves
+// with negative effects are committed together, falling back to the strongest of them when the
+// combination does not pay off.
+class BatchMoveSearch {
+public:
+    BatchMoveSearch(const CellTable& cellTable, const BatchEvaluator& evaluate, BatchDesign design, size_t movesPerRound);
+
+    // Run one round from assignment/cost; returns true and updates both when a better assignment was found
+    bool round(CellAssignment& assignment, float& cost, Random& random);
+
+    size_t evaluations() const;
+    size_t committedMoves() const;
+
+private:
+    const CellTable& cellTable;
+    BatchEvaluator evaluate;
+    BatchDesign design;
+    size_t movesPerRound;
+    size_t evaluationCount;
+    size_t committedCount;
+    std::vector<size_t> movableGates;
+
+    std::vector<CellMove> drawMoves(const CellAssignment& assignment, Random& random) const;
+    std::vector<std::vector<bool>> designRows(size_t numMoves, Random& random) const;
+};
+
+#endif // BATCH_MOVE_SEARCH_HPP
@@ -0,0 +1,116 @@
+#include "CellAssignment.hpp"
+#include <iostream>
+
+CellTable::CellTable(const Netlist& netlist, const std::vector<Cell>& cells,
+                     const std::unordered_map<std::string, std::vector<std::string>>& gateMapping)
+    : cells(cells) {
+    if (cells.size() >= kNoCell) {
+        std::cerr << "Error: The library has more cells than a cell index can hold." << std::endl;
+        exit(1);
+    }
+    for (size_t i = 0; i < cells.size(); ++i) {
+        cellNames.push_back(cells[i].cell_name);
+        cellIds[cells[i].cell_name] = static_cast<uint16_t>(i);
+    }
+
+    std::unordered_map<std::string, uint32_t> typeIndex;
+    typeCandidates.push_back(std::vector<uint16_t>());  // Gates of unknown types have no candidates
+    for (const auto& gate : netlist.gates) {
+        auto known = typeIndex.find(gate.type);
+        if (known != typeIndex.end()) {
+            gateTypes.push_back(known->second);
+            continue;
+        }
+        uint32_t index = 0;
+        auto it = gateMapping.find(gate.type);
+        if (it != gateMapping.end()) {
+            index = static_cast<uint32_t>(typeCandidates.size());
+            typeCandidates.push_back(std::vector<uint16_t>());
+            for (const auto& cellName : it->second) {
+                uint16_t cell = id(cellName);
+                if (cell != kNoCell) {
+                    typeCandidates.back().push_back(cell);
+                }
+            }
+        }
+        typeIndex[gate.type] = index;
+        gateTypes.push_back(index);
+    }
+}
+
+size_t CellTable::numGates() const {
+    return gateTypes.size();
+}
+
+size_t CellTable::numCells() const {
+    return cellNames.size();
+}
+
+const std::string& CellTable::name(uint16_t cell) const {
+    return cellNames[cell];
+}
+
+const std::vector<std::string>& CellTable::names() const {
+    return cellNames;
+}
+
+uint16_t CellTable::id(const std::string& name) const {
+    auto it = cellIds.find(name);
+    return it != cellIds.end() ? it->second : kNoCell;
+}
+
+const Cell& CellTable::cell(uint16_t cell) const {
+    return cells[cell];
+}
+
+const std::vector<uint16_t>& CellTable::candidates(size_t gate) const {
+    return typeCandidates[gateTypes[gate]];
+}
+
+size_t CellTable::numTypes() const {
+    return typeCandidates.size();
+}
+
+size_t CellTable::typeOf(size_t gate) const {
+    return gateTypes[gate];
+}
+
+const std::vector<uint16_t>& CellTable::typeCells(size_t type) const {
+    return typeCandidates[type];
+}
+
+void CellTable::setTypeCells(size_t type, const std::vector<uint16_t>& cells) {
+    typeCandidates[type] = cells;
+}
+
+CellAssignment::CellAssignment() {}
+
+CellAssignment::CellAssignment(size_t numGates) : cellOf(numGates, kNoCell) {}
+
+size_t CellAssignment::size() const {
+    return cellOf.size();
+}
+
+uint16_t CellAssignment::operator[](size_t gate) const {
+    return cellOf[gate];
+}
+
+void CellAssignment::set(size_t gate, uint16_t cell) {
+    cellOf[gate] = cell;
+}
+
+void CellAssignment::apply(const CellMove& move) {
+    cellOf[move.gate] = move.newCell;
+}
+
+void CellAssignment::undo(const CellMove& move) {
+    cellOf[move.gate] = move.oldCell;
+}
+
+const std::vector<uint16_t>& CellAssignment::cells() const {
+    return cellOf;
+}
+
+bool CellAssignment::operator==(const CellAssignment& other) const {
+    return cellOf == other.cellOf;
+}
@@ -0,0 +1,74 @@
+#ifndef CELL_ASSIGNMENT_HPP
+#define CELL_ASSIGNMENT_HPP
+
+#include "CellLibraryParser.hpp"
+#include "NetlistParser.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const uint16_t kNoCell = 0xffff;
+
+// Change of one gate from oldCell to newCell
+struct CellMove {
+    uint32_t gate;
+    uint16_t oldCell;
+    uint16_t newCell;
+};
+
+// Dense numbering of the library cells (in library order) and the cells each gate may use
+class CellTable {
+public:
+    CellTable(const Netlist& netlist, const std::vector<Cell>& cells,
+              const std::unordered_map<std::string, std::vector<std::string>>& gateMapping);
+
+    size_t numGates() const;
+    size_t numCells() const;
+    const std::string& name(uint16_t cell) const;
+    const std::vector<std::string>& names() const;
+    uint16_t id(const std::string& name) const;
+    const Cell& cell(uint16_t cell) const;
+
+    // Cells that can implement the gate, in the order GateMapper listed them
+    const std::vector<uint16_t>& candidates(size_t gate) const;
+
+    // Gate types, numbered in order of first appearance; type 0 collects gates without candidates
+    size_t numTypes() const;
+    size_t typeOf(size_t gate) const;
+    const std::vector<uint16_t>& typeCells(size_t type) const;
+    // Restrict the candidates of a type, e.g. after pruning the library
+    void setTypeCells(size_t type, const std::vector<uint16_t>& cells);
+
+private:
+    std::vector<Cell> cells;
+    std::vector<std::string> cellNames;
+    std::unordered_map<std::string, uint16_t> cellIds;
+    std::vector<std::vector<uint16_t>> typeCandidates;
+    std::vector<uint32_t> gateTypes;
+};
+
+// Cell index per gate. Moves are applied and undone with a single array store.
+class CellAssignment {
+public:
+    CellAssignment();
+    explicit CellAssignment(size_t numGates);
+
+    size_t size() const;
+    uint16_t operator[](size_t gate) const;
+    void set(size_t gate, uint16_t cell);
+    void apply(const CellMove& move);
+    void undo(const CellMove& move);
+    const std::vector<uint16_t>& cells() const;
+
+    bool operator==(const CellAssignment& other) const;
+
+private:
+    std::vector<uint16_t> cellOf;
+};
+
+// Costs of several assignments, in order; implementations may evaluate them concurrently
+typedef std::function<std::vector<float>(const std::vector<CellAssignment>&)> BatchEvaluator;
+
+#endif // CELL_ASSIGNMENT_HPP
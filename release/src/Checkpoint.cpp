@@ -0,0 +1,80 @@
+#include "Checkpoint.hpp"
+#include <unistd.h>
+
+CheckpointWriter::CheckpointWriter(const std::string& path) : path(path), tempPath(path + ".tmp"), failed(false) {
+    file = std::fopen(tempPath.c_str(), "wb");
+    failed = file == nullptr;
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    if (file != nullptr) {
+        std::fclose(file);
+        std::remove(tempPath.c_str());
+    }
+}
+
+void CheckpointWriter::write(const void* data, size_t size) {
+    if (!failed && size > 0 && std::fwrite(data, 1, size, file) != size) {
+        failed = true;
+    }
+}
+
+void CheckpointWriter::putString(const std::string& value) {
+    put<uint64_t>(value.size());
+    write(value.data(), value.size());
+}
+
+bool CheckpointWriter::commit() {
+    if (file == nullptr) {
+        return false;
+    }
+    failed = failed || std::fflush(file) != 0 || fsync(fileno(file)) != 0;
+    failed = std::fclose(file) != 0 || failed;
+    file = nullptr;
+    if (failed || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+CheckpointReader::CheckpointReader(const std::string& path) : remaining(0), failed(false) {
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        failed = true;
+        return;
+    }
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        long size = std::ftell(file);
+        remaining = size > 0 ? static_cast<uint64_t>(size) : 0;
+    }
+    std::rewind(file);
+}
+
+CheckpointReader::~CheckpointReader() {
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
+
+bool CheckpointReader::isOpen() const {
+    return file != nullptr;
+}
+
+bool CheckpointReader::read(void* data, size_t size) {
+    if (failed || size > remaining || (size > 0 && std::fread(data, 1, size, file) != size)) {
+        failed = true;
+        return false;
+    }
+    remaining -= size;
+    return true;
+}
+
+bool CheckpointReader::getString(std::string& value) {
+    std::vector<char> chars;
+    if (!getVector(chars)) {
+        return false;
+    }
+    value.assign(chars.begin(), chars.end());
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Binary checkpoint files. Values are stored in native byte order, so a checkpoint is only read back on
+// the machine type that wrote it. The writer fills a temporary file next to the checkpoint and renames it
+// over the old one once everything is on disk, so a run killed mid-write leaves the previous checkpoint.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const std::string& path);
+    ~CheckpointWriter();
+
+    template <typename T>
+    void put(const T& value) {
+        write(&value, sizeof(T));
+    }
+    template <typename T>
+    void putVector(const std::vector<T>& values) {
+        put<uint64_t>(values.size());
+        write(values.data(), values.size() * sizeof(T));
+    }
+    void putString(const std::string& value);
+
+    // Sync the temporary file and move it into place; returns false if anything failed
+    bool commit();
+
+private:
+    std::string path;
+    std::string tempPath;
+    FILE* file;
+    bool failed;
+
+    void write(const void* data, size_t size);
+};
+
+// Reads a checkpoint field by field; every getter returns false once the file is short or malformed
+class CheckpointReader {
+public:
+    explicit CheckpointReader(const std::string& path);
+    ~CheckpointReader();
+
+    bool isOpen() const;
+
+    template <typename T>
+    bool get(T& value) {
+        return read(&value, sizeof(T));
+    }
+    template <typename T>
+    bool getVector(std::vector<T>& values) {
+        uint64_t count;
+        if (!get(count) || count > remaining / sizeof(T)) {
+            failed = true;
+            return false;
+        }
+        values.resize(count);
+        return read(values.data(), count * sizeof(T));
+    }
+    bool getString(std::string& value);
+
+private:
+    FILE* file;
+    uint64_t remaining;  // Bytes left in the file, bounds the sizes of vectors and strings
+    bool failed;
+
+    bool read(void* data, size_t size);
+};
+
+#endif // CHECKPOINT_HPP
@@ -0,0 +1,80 @@
+#include "ConePartitioner.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+static const size_t kNoPartition = static_cast<size_t>(-1);
+
+ConePartitioner::ConePartitioner(const CellTable& cellTable, const NetlistGraph& graph, size_t numPartitions)
+    : coneCount(0), cutCount(0) {
+    size_t numGates = graph.numGates();
+    std::vector<size_t> cone(numGates, kNoPartition);
+    const std::vector<size_t>& order = graph.order();
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        size_t gate = *it;
+        // Majority cone of the fanouts, ties to the older cone; gates on loops may see no labeled fanout
+        std::unordered_map<size_t, size_t> votes;
+        size_t chosen = kNoPartition;
+        for (size_t fanout : graph.fanouts(gate)) {
+            if (cone[fanout] == kNoPartition) {
+                continue;
+            }
+            size_t count = ++votes[cone[fanout]];
+            if (chosen == kNoPartition || count > votes[chosen] || (count == votes[chosen] && cone[fanout] < chosen)) {
+                chosen = cone[fanout];
+            }
+        }
+        cone[gate] = chosen != kNoPartition ? chosen : coneCount++;
+    }
+
+    std::vector<std::vector<size_t>> coneGates(coneCount);
+    for (size_t gate = 0; gate < numGates; ++gate) {
+        if (cellTable.candidates(gate).size() > 1) {
+            coneGates[cone[gate]].push_back(gate);
+        }
+    }
+    std::vector<size_t> byWeight(coneCount);
+    for (size_t c = 0; c < coneCount; ++c) {
+        byWeight[c] = c;
+    }
+    std::stable_sort(byWeight.begin(), byWeight.end(),
+                     [&](size_t a, size_t b) { return coneGates[a].size() > coneGates[b].size(); });
+
+    parts.assign(std::max<size_t>(numPartitions, 1), std::vector<size_t>());
+    std::vector<size_t> partitionOf(coneCount, kNoPartition);
+    for (size_t c : byWeight) {
+        size_t lightest = 0;
+        for (size_t p = 1; p < parts.size(); ++p) {
+            if (parts[p].size() < parts[lightest].size()) {
+                lightest = p;
+            }
+        }
+        partitionOf[c] = lightest;
+        parts[lightest].insert(parts[lightest].end(), coneGates[c].begin(), coneGates[c].end());
+    }
+    parts.erase(std::remove_if(parts.begin(), parts.end(), [](const std::vector<size_t>& part) { return part.empty(); }),
+                parts.end());
+    for (auto& part : parts) {
+        std::sort(part.begin(), part.end());
+    }
+
+    for (size_t gate = 0; gate < numGates; ++gate) {
+        for (size_t fanin : graph.fanins(gate)) {
+            bool movable = cellTable.candidates(gate).size() > 1 || cellTable.candidates(fanin).size() > 1;
+            if (movable && partitionOf[cone[gate]] != partitionOf[cone[fanin]]) {
+                cutCount++;
+            }
+        }
+    }
+}
+
+const std::vector<std::vector<size_t>>& ConePartitioner::partitions() const {
+    return parts;
+}
+
+size_t ConePartitioner::numCones() const {
+    return coneCount;
+}
+
+size_t ConePartitioner::cutEdges() const {
+    return cutCount;
+}
@@ -0,0 +1,30 @@
+#ifndef CONE_PARTITIONER_HPP
+#define CONE_PARTITIONER_HPP
+
+#include "CellAssignment.hpp"
+#include "NetlistGraph.hpp"
+#include <cstddef>
+#include <vector>
+
+// Split the movable gates into a few loosely coupled groups that can be optimized side by side.
+// Every gate without fanout gates starts an output cone; walking backwards in topological order,
+// each other gate joins the cone that most of its fanouts belong to, so logic shared between cones
+// ends up where it cuts the fewest edges. The cones are then packed into the requested number of
+// partitions, largest first into the partition with the fewest movable gates.
+class ConePartitioner {
+public:
+    ConePartitioner(const CellTable& cellTable, const NetlistGraph& graph, size_t numPartitions);
+
+    // Movable gates of every non-empty partition
+    const std::vector<std::vector<size_t>>& partitions() const;
+    size_t numCones() const;
+    // Gate connections between different partitions, counting only edges with a movable end
+    size_t cutEdges() const;
+
+private:
+    std::vector<std::vector<size_t>> parts;
+    size_t coneCount;
+    size_t cutCount;
+};
+
+#endif // CONE_PARTITIONER_HPP
@@ -0,0 +1,62 @@
+#include "CoolingSchedule.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const double kRateWindow = 100.0;  // Moves the acceptance rate averages over
+static const double kControlGain = 0.05;  // Log-temperature change per move and unit of rate error
+
+CoolingSchedule::CoolingSchedule(double initialAcceptance, size_t calibrationMoves)
+    : initialAcceptance(std::min(std::max(initialAcceptance, 0.01), 0.99)), calibrationMoves(std::max<size_t>(calibrationMoves, 1)),
+      uphillMoves(0), uphillSum(0.0), currentTemp(0.0), rate(1.0) {}
+
+double CoolingSchedule::temperature() const {
+    return currentTemp;
+}
+
+bool CoolingSchedule::calibrated() const {
+    return uphillMoves >= calibrationMoves;
+}
+
+double CoolingSchedule::acceptanceRate() const {
+    return rate;
+}
+
+double CoolingSchedule::targetRate(double progress) {
+    if (progress < 0.15) {
+        return 0.44 + 0.56 * std::pow(560.0, -progress / 0.15);
+    }
+    if (progress < 0.65) {
+        return 0.44;
+    }
+    return 0.44 * std::pow(440.0, -(progress - 0.65) / 0.35);
+}
+
+void CoolingSchedule::record(double delta, bool accepted, double progress) {
+    rate += ((accepted ? 1.0 : 0.0) - rate) / kRateWindow;
+    if (!calibrated()) {
+        // exp(-mean uphill / T0) = initialAcceptance, refined with every uphill move until calibrated
+        if (delta > 0.0) {
+            uphillMoves++;
+            uphillSum += delta;
+            currentTemp = -(uphillSum / uphillMoves) / std::log(initialAcceptance);
+        }
+        return;
+    }
+    currentTemp *= std::exp(kControlGain * (targetRate(progress) - rate));
+}
+
+void CoolingSchedule::save(CheckpointWriter& out) const {
+    out.put<uint64_t>(uphillMoves);
+    out.put(uphillSum);
+    out.put(currentTemp);
+    out.put(rate);
+}
+
+bool CoolingSchedule::load(CheckpointReader& in) {
+    uint64_t moves;
+    if (!in.get(moves) || !in.get(uphillSum) || !in.get(currentTemp) || !in.get(rate)) {
+        return false;
+    }
+    uphillMoves = moves;
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef COOLING_SCHEDULE_HPP
+#define COOLING_SCHEDULE_HPP
+
+#include "Checkpoint.hpp"
+#include <cstddef>
+
+// Annealing temperature that follows the cost scale of the estimator instead of a fixed constant.
+// The initial temperature is calibrated from the first uphill moves the search draws, so that an
+// average one is accepted with the given probability. Afterwards the temperature is steered so that
+// the observed acceptance rate follows the modified Lam target: from near 1 down to 0.44 over the
+// first 15% of the budget, 0.44 until 65%, then exponentially down towards 0.001 at the end.
+class CoolingSchedule {
+public:
+    CoolingSchedule(double initialAcceptance, size_t calibrationMoves);
+
+    // Zero until the first uphill move was seen, which makes the search greedy until then
+    double temperature() const;
+    bool calibrated() const;
+    // Report a decided move: its cost change, whether it was accepted and the used share of the budget
+    void record(double delta, bool accepted, double progress);
+
+    double acceptanceRate() const;
+    static double targetRate(double progress);
+
+    void save(CheckpointWriter& out) const;
+    bool load(CheckpointReader& in);
+
+private:
+    double initialAcceptance;
+    size_t calibrationMoves;
+    size_t uphillMoves;
+    double uphillSum;
+    double currentTemp;
+    double rate;  // Exponential moving average of acceptances
+};
+
+#endif // COOLING_SCHEDULE_HPP
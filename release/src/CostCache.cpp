@@ -0,0 +1,243 @@
+#include "CostCache.hpp"
+#include <cstdio>
+#include <iostream>
+#include <limits>
+
+static const uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+static const uint64_t kFnvPrime = 0x100000001b3ULL;
+static const uint64_t kDiskMagic = 0x3143434f4354534fULL;  // Identifies cost cache files
+
+static uint64_t fnv1a(const std::string& text, uint64_t hash = kFnvOffset) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Hash the full contents of a file, falling back to its path when it cannot be read
+static uint64_t fileFingerprint(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return fnv1a(path);
+    }
+    uint64_t hash = kFnvOffset;
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        hash = fnv1a(std::string(buffer, static_cast<size_t>(file.gcount())), hash);
+    }
+    return hash;
+}
+
+MappingHasher::MappingHasher(const Netlist& netlist, const CellTable& cellTable) : netlist(netlist) {
+    gateSeeds.reserve(netlist.gates.size());
+    for (const auto& gate : netlist.gates) {
+        gateSeeds.push_back(fnv1a(gate.name));
+    }
+    cellSeeds.reserve(cellTable.numCells());
+    for (const auto& name : cellTable.names()) {
+        cellSeeds.push_back(fnv1a(name));
+    }
+}
+
+MappingKey MappingHasher::pairKey(size_t gateIndex, uint16_t cell) const {
+    uint64_t cellSeed = cellSeeds[cell];
+    MappingKey key;
+    key.high = splitmix64(gateSeeds[gateIndex] ^ splitmix64(cellSeed));
+    key.low = splitmix64(key.high ^ gateSeeds[gateIndex] ^ (cellSeed << 1));
+    return key;
+}
+
+MappingKey MappingHasher::hash(const CellAssignment& assignment) const {
+    MappingKey key;
+    for (size_t i = 0; i < assignment.size(); ++i) {
+        if (assignment[i] != kNoCell) {
+            MappingKey gateKey = pairKey(i, assignment[i]);
+            key.high ^= gateKey.high;
+            key.low ^= gateKey.low;
+        }
+    }
+    return key;
+}
+
+MappingKey MappingHasher::update(const MappingKey& key, const CellMove& move) const {
+    MappingKey oldKey = pairKey(move.gate, move.oldCell);
+    MappingKey newKey = pairKey(move.gate, move.newCell);
+    MappingKey updated;
+    updated.high = key.high ^ oldKey.high ^ newKey.high;
+    updated.low = key.low ^ oldKey.low ^ newKey.low;
+    return updated;
+}
+
+uint64_t MappingHasher::netlistFingerprint() const {
+    uint64_t hash = fnv1a(netlist.moduleName);
+    for (const auto& gate : netlist.gates) {
+        hash = fnv1a(gate.type, hash);
+        hash = fnv1a(gate.name, hash);
+        for (const auto& input : gate.inputs) {
+            hash = fnv1a(input, hash);
+        }
+        hash = fnv1a(gate.output, hash);
+    }
+    return hash;
+}
+
+CostCache::CostCache(size_t capacity, const std::string& diskFile, size_t diskCapacity) : capacity(capacity), hitCount(0), missCount(0) {
+    if (!diskFile.empty() && diskCapacity > 0) {
+        diskSlots.assign(diskCapacity, DiskSlot());
+        loadDiskFile(diskFile);
+    }
+}
+
+void CostCache::loadDiskFile(const std::string& diskFile) {
+    std::ifstream in(diskFile, std::ios::binary);
+    bool valid = false;
+    if (in.is_open()) {
+        uint64_t magic = 0;
+        valid = in.read(reinterpret_cast<char*>(&magic), sizeof(magic)) && magic == kDiskMagic;
+        uint64_t record[2];
+        float cost;
+        while (valid && in.read(reinterpret_cast<char*>(record), sizeof(record)) &&
+               in.read(reinterpret_cast<char*>(&cost), sizeof(cost))) {
+            MappingKey key;
+            key.high = record[0];
+            key.low = record[1];
+            // Files written before failures were kept out of the cache may still hold them
+            if (cost < std::numeric_limits<float>::max()) {
+                DiskSlot& slot = diskSlot(key);
+                slot.key = key;
+                slot.cost = cost;
+                slot.used = true;
+            }
+        }
+        in.close();
+        if (!valid) {
+            std::cerr << "Warning: Ignoring unrecognized cost cache file " << diskFile << std::endl;
+        }
+    }
+
+    if (valid) {
+        diskLog.open(diskFile, std::ios::binary | std::ios::app);
+    } else {
+        diskLog.open(diskFile, std::ios::binary | std::ios::trunc);
+        diskLog.write(reinterpret_cast<const char*>(&kDiskMagic), sizeof(kDiskMagic));
+    }
+    if (!diskLog.is_open()) {
+        std::cerr << "Error: Could not open cost cache file " << diskFile << std::endl;
+    }
+}
+
+bool CostCache::lookup(const MappingKey& key, float& cost) {
+    auto it = lruIndex.find(key);
+    if (it != lruIndex.end()) {
+        cost = it->second->second;
+        lru.splice(lru.begin(), lru, it->second);
+        hitCount++;
+        return true;
+    }
+    const DiskSlot* slot = diskSlots.empty() ? nullptr : &diskSlot(key);
+    if (slot && slot->used && slot->key == key) {
+        cost = slot->cost;
+        touch(key, cost);
+        hitCount++;
+        return true;
+    }
+    missCount++;
+    return false;
+}
+
+void CostCache::insert(const MappingKey& key, float cost) {
+    // A failed evaluation may be transient, and persisting it would poison every later run
+    if (cost >= std::numeric_limits<float>::max()) {
+        return;
+    }
+    touch(key, cost);
+    if (!diskLog.is_open()) {
+        return;
+    }
+    DiskSlot& slot = diskSlot(key);
+    if (!slot.used || !(slot.key == key)) {
+        // A key evicted from its slot may be appended again; loading keeps the last record
+        slot.key = key;
+        slot.cost = cost;
+        slot.used = true;
+        uint64_t record[2] = {key.high, key.low};
+        diskLog.write(reinterpret_cast<const char*>(record), sizeof(record));
+        diskLog.write(reinterpret_cast<const char*>(&cost), sizeof(cost));
+        diskLog.flush();
+    }
+}
+
+CostCache::DiskSlot& CostCache::diskSlot(const MappingKey& key) {
+    return diskSlots[MappingKeyHash()(key) % diskSlots.size()];
+}
+
+void CostCache::touch(const MappingKey& key, float cost) {
+    if (capacity == 0) {
+        return;
+    }
+    auto it = lruIndex.find(key);
+    if (it != lruIndex.end()) {
+        it->second->second = cost;
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+    lru.push_front(std::make_pair(key, cost));
+    lruIndex[key] = lru.begin();
+    if (lru.size() > capacity) {
+        lruIndex.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+size_t CostCache::hits() const {
+    return hitCount;
+}
+
+size_t CostCache::misses() const {
+    return missCount;
+}
+
+std::string CostCache::diskFileName(const std::string& cacheDir, uint64_t netlistFingerprint,
+                                    const std::string& cellLibraryFile, const std::string& costEstimator) {
+    uint64_t triple = splitmix64(netlistFingerprint ^ splitmix64(fileFingerprint(cellLibraryFile) ^ splitmix64(fileFingerprint(costEstimator))));
+    char name[64];
+    std::snprintf(name, sizeof(name), "cost_cache_%016llx.bin", static_cast<unsigned long long>(triple));
+    return cacheDir + "/" + name;
+}
+
+void CostCache::save(CheckpointWriter& out) const {
+    out.put<uint64_t>(hitCount);
+    out.put<uint64_t>(missCount);
+    out.put<uint64_t>(lru.size());
+    // Oldest first, so loading re-inserts them in the same recency order
+    for (auto it = lru.rbegin(); it != lru.rend(); ++it) {
+        out.put(it->first);
+        out.put(it->second);
+    }
+}
+
+bool CostCache::load(CheckpointReader& in) {
+    uint64_t hits, misses, count;
+    if (!in.get(hits) || !in.get(misses) || !in.get(count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        MappingKey key;
+        float cost;
+        if (!in.get(key) || !in.get(cost)) {
+            return false;
+        }
+        touch(key, cost);
+    }
+    hitCount = hits;
+    missCount = misses;
+    return true;
+}
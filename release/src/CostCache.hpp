@@ -0,0 +1,92 @@
+#ifndef COST_CACHE_HPP
+#define COST_CACHE_HPP
+
+#include "CellAssignment.hpp"
+#include "Checkpoint.hpp"
+#include "NetlistParser.hpp"
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 128-bit hash of a complete gate-to-cell assignment
+struct MappingKey {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    bool operator==(const MappingKey& other) const { return high == other.high && low == other.low; }
+};
+
+struct MappingKeyHash {
+    size_t operator()(const MappingKey& key) const { return static_cast<size_t>(key.low ^ (key.high * 0x9e3779b97f4a7c15ULL)); }
+};
+
+// Zobrist-style hashing: every (gate, cell) pair has a pseudo-random 128-bit key and a mapping hashes
+// to the XOR of the keys it uses, so a single-gate move updates the hash in O(1). Keys are derived from
+// the gate and cell names, which keeps hashes stable across runs.
+class MappingHasher {
+public:
+    MappingHasher(const Netlist& netlist, const CellTable& cellTable);
+
+    MappingKey hash(const CellAssignment& assignment) const;
+    MappingKey update(const MappingKey& key, const CellMove& move) const;
+
+    // Fingerprint of the netlist structure, used to tie persisted costs to one design
+    uint64_t netlistFingerprint() const;
+
+private:
+    const Netlist& netlist;
+    std::vector<uint64_t> gateSeeds;
+    std::vector<uint64_t> cellSeeds;
+
+    MappingKey pairKey(size_t gateIndex, uint16_t cell) const;
+};
+
+// Two-tier cost cache: a bounded in-memory LRU backed by an optional append-only file that is
+// reloaded by later runs for the same design/library/estimator triple. The file is indexed by a
+// direct-mapped table of diskCapacity slots, so memory stays bounded however long the file grows;
+// a key whose slot was taken over by another key is a miss and is re-evaluated.
+// Failed evaluations, reported as the maximum float, are never cached.
+class CostCache {
+public:
+    CostCache(size_t capacity, const std::string& diskFile, size_t diskCapacity);
+
+    bool lookup(const MappingKey& key, float& cost);
+    void insert(const MappingKey& key, float cost);
+
+    size_t hits() const;
+    size_t misses() const;
+
+    // The in-memory tier in recency order and the hit statistics; the disk tier persists on its own
+    void save(CheckpointWriter& out) const;
+    bool load(CheckpointReader& in);
+
+    // Name of the disk tier file inside cacheDir for the given design, library and estimator
+    static std::string diskFileName(const std::string& cacheDir, uint64_t netlistFingerprint,
+                                    const std::string& cellLibraryFile, const std::string& costEstimator);
+
+private:
+    typedef std::list<std::pair<MappingKey, float>> LruList;
+
+    struct DiskSlot {
+        MappingKey key;
+        float cost = 0.0f;
+        bool used = false;
+    };
+
+    size_t capacity;
+    LruList lru;
+    std::unordered_map<MappingKey, LruList::iterator, MappingKeyHash> lruIndex;
+    std::vector<DiskSlot> diskSlots;
+    std::ofstream diskLog;
+    size_t hitCount;
+    size_t missCount;
+
+    void touch(const MappingKey& key, float cost);
+    void loadDiskFile(const std::string& diskFile);
+    DiskSlot& diskSlot(const MappingKey& key);
+};
+
+#endif // COST_CACHE_HPP
@@ -0,0 +1,165 @@
+#include "EquivalenceChecker.hpp"
+#include "Aig.hpp"
+#include "SatSweeper.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+static const size_t kBlockWords = 16;         // 1024 patterns per simulation pass
+static const size_t kSweepConflicts = 1000;  // Per candidate pair while sweeping
+
+EquivalenceChecker::EquivalenceChecker(const Netlist& referenceNetlist, const Netlist& implementationNetlist,
+                                       const std::vector<GateFunction>& implementationFunctions)
+    : referenceNetlist(referenceNetlist), implementationNetlist(implementationNetlist), implementationFunctions(implementationFunctions),
+      reference(referenceNetlist), implementation(implementationNetlist, implementationFunctions), inputNames(referenceNetlist.inputs),
+      outputNames(referenceNetlist.outputs) {
+    if (!reference.error().empty()) {
+        errorMessage = "Reference netlist: " + reference.error();
+        return;
+    }
+    if (!implementation.error().empty()) {
+        errorMessage = "Implementation netlist: " + implementation.error();
+        return;
+    }
+
+    std::unordered_map<std::string, size_t> referenceInputs;
+    for (size_t i = 0; i < inputNames.size(); ++i) {
+        referenceInputs[inputNames[i]] = i;
+    }
+    if (implementationNetlist.inputs.size() != inputNames.size()) {
+        errorMessage = "The netlists have different numbers of primary inputs";
+        return;
+    }
+    for (const auto& input : implementationNetlist.inputs) {
+        auto it = referenceInputs.find(input);
+        if (it == referenceInputs.end()) {
+            errorMessage = "Primary input " + input + " is missing from the reference netlist";
+            return;
+        }
+        inputMap.push_back(it->second);
+    }
+
+    std::unordered_map<std::string, size_t> implementationOutputs;
+    for (size_t o = 0; o < implementationNetlist.outputs.size(); ++o) {
+        implementationOutputs[implementationNetlist.outputs[o]] = o;
+    }
+    if (implementationNetlist.outputs.size() != outputNames.size()) {
+        errorMessage = "The netlists have different numbers of primary outputs";
+        return;
+    }
+    for (const auto& output : outputNames) {
+        auto it = implementationOutputs.find(output);
+        if (it == implementationOutputs.end()) {
+            errorMessage = "Primary output " + output + " is missing from the implementation netlist";
+            return;
+        }
+        outputMap.push_back(it->second);
+    }
+}
+
+EquivalenceResult EquivalenceChecker::check(size_t patterns, Random& random) {
+    EquivalenceResult result;
+    if (!errorMessage.empty()) {
+        result.error = errorMessage;
+        return result;
+    }
+
+    std::vector<uint64_t> referenceInputs;
+    std::vector<uint64_t> implementationInputs(inputMap.size() * kBlockWords);
+    bool firstBlock = true;
+    while (result.patterns < patterns) {
+        size_t words = std::min(kBlockWords, (patterns - result.patterns + 63) / 64);
+        reference.randomInputs(random, words, referenceInputs);
+        if (firstBlock) {
+            // Pattern 0 sets every input to 0 and pattern 1 every input to 1
+            for (size_t i = 0; i < inputNames.size(); ++i) {
+                referenceInputs[i * words] = (referenceInputs[i * words] & ~3ULL) | 2ULL;
+            }
+            firstBlock = false;
+        }
+        for (size_t i = 0; i < inputMap.size(); ++i) {
+            std::copy(referenceInputs.begin() + inputMap[i] * words, referenceInputs.begin() + (inputMap[i] + 1) * words,
+                      implementationInputs.begin() + i * words);
+        }
+        reference.simulate(referenceInputs, words);
+        implementation.simulate(implementationInputs, words);
+
+        for (size_t o = 0; o < outputNames.size(); ++o) {
+            const uint64_t* expected = reference.values(reference.outputNet(o));
+            const uint64_t* actual = implementation.values(implementation.outputNet(outputMap[o]));
+            for (size_t w = 0; w < words; ++w) {
+                uint64_t difference = expected[w] ^ actual[w];
+                if (difference == 0) {
+                    continue;
+                }
+                // Report the lowest failing pattern of the block
+                size_t bit = 0;
+                while (!(difference >> bit & 1)) {
+                    bit++;
+                }
+                result.output = outputNames[o];
+                for (size_t i = 0; i < inputNames.size(); ++i) {
+                    result.counterexample.emplace_back(inputNames[i], (referenceInputs[i * words + w] >> bit & 1) != 0);
+                }
+                result.patterns += w * 64 + bit + 1;
+                return result;
+            }
+        }
+        result.patterns += words * 64;
+    }
+    result.equivalent = true;
+    return result;
+}
+
+EquivalenceResult EquivalenceChecker::prove(Random& random, size_t conflictLimit) {
+    EquivalenceResult result;
+    if (!errorMessage.empty()) {
+        result.error = errorMessage;
+        return result;
+    }
+
+    Aig aig;
+    std::vector<uint32_t> referenceInputs;
+    for (size_t i = 0; i < inputNames.size(); ++i) {
+        referenceInputs.push_back(aig.addInput());
+    }
+    std::vector<uint32_t> implementationInputs;
+    for (size_t input : inputMap) {
+        implementationInputs.push_back(referenceInputs[input]);
+    }
+    std::vector<uint32_t> referenceOutputs;
+    std::vector<uint32_t> implementationOutputs;
+    if (!aig.addNetlist(referenceNetlist, std::vector<GateFunction>(), referenceInputs, referenceOutputs, result.error)) {
+        result.error = "Reference netlist: " + result.error;
+        return result;
+    }
+    // Structural hashing shares every part of the implementation that matches the reference; the sweep
+    // only needs to check the nodes it adds
+    size_t implementationNodes = aig.numNodes();
+    if (!aig.addNetlist(implementationNetlist, implementationFunctions, implementationInputs, implementationOutputs, result.error)) {
+        result.error = "Implementation netlist: " + result.error;
+        return result;
+    }
+
+    SatSweeper sweeper(aig, random, kSweepConflicts, implementationNodes);
+    sweeper.sweep();
+    for (size_t o = 0; o < outputNames.size(); ++o) {
+        std::vector<bool> counterexample;
+        SatResult outcome = sweeper.prove(sweeper.map(referenceOutputs[o]), sweeper.map(implementationOutputs[outputMap[o]]), conflictLimit,
+                                          &counterexample);
+        if (outcome == SAT_SATISFIABLE) {
+            result.output = outputNames[o];
+            for (size_t i = 0; i < inputNames.size(); ++i) {
+                result.counterexample.emplace_back(inputNames[i], counterexample[i]);
+            }
+            break;
+        }
+        if (outcome == SAT_UNDECIDED) {
+            result.undecidedOutputs++;
+        }
+    }
+    result.satCalls = sweeper.satCalls();
+    result.mergedNodes = sweeper.merged();
+    result.proved = result.output.empty() && result.undecidedOutputs == 0;
+    result.equivalent = result.proved;
+    return result;
+}
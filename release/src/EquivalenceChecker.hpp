@@ -0,0 +1,55 @@
+#ifndef EQUIVALENCE_CHECKER_HPP
+#define EQUIVALENCE_CHECKER_HPP
+
+#include "LogicSimulator.hpp"
+#include "NetlistParser.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct EquivalenceResult {
+    bool equivalent = false;
+    size_t patterns = 0;   // Patterns simulated before the check ended
+    std::string error;     // Set when the netlists cannot be compared, e.g. different ports or unknown cells
+    std::string output;    // First primary output found to differ
+    std::vector<std::pair<std::string, bool>> counterexample;  // Input values of the failing pattern
+    // Set by prove
+    bool proved = false;
+    size_t undecidedOutputs = 0;  // Outputs the solver gave up on within the conflict limit
+    size_t satCalls = 0;
+    size_t mergedNodes = 0;
+};
+
+// Random-simulation equivalence check of two combinational netlists. Both are simulated bit-parallel
+// with the same random input patterns, primary inputs and outputs matched by name, and the check stops
+// at the first block in which an output differs, reporting one failing pattern. Passing is evidence,
+// not proof: faults that only show for rare input patterns can be missed.
+//
+// prove settles the question: both netlists are built into one AIG over shared inputs and SAT swept,
+// and every output pair that the sweep has not merged already is decided by the SAT solver.
+class EquivalenceChecker {
+public:
+    // The implementation gate functions are given per gate, e.g. derived from the cells of a mapped
+    // netlist. The netlists must outlive the checker.
+    EquivalenceChecker(const Netlist& reference, const Netlist& implementation, const std::vector<GateFunction>& implementationFunctions);
+
+    EquivalenceResult check(size_t patterns, Random& random);
+    // Formal check; conflictLimit bounds the SAT call per output pair, 0 for no limit
+    EquivalenceResult prove(Random& random, size_t conflictLimit);
+
+private:
+    const Netlist& referenceNetlist;
+    const Netlist& implementationNetlist;
+    std::vector<GateFunction> implementationFunctions;
+    LogicSimulator reference;
+    LogicSimulator implementation;
+    std::vector<std::string> inputNames;   // Reference primary inputs
+    std::vector<std::string> outputNames;  // Reference primary outputs
+    std::vector<size_t> inputMap;          // Implementation input -> reference input
+    std::vector<size_t> outputMap;         // Reference output -> implementation output
+    std::string errorMessage;
+};
+
+#endif // EQUIVALENCE_CHECKER_HPP
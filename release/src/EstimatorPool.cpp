@@ -0,0 +1,307 @@
+#include "EstimatorPool.hpp"
+#include "NetlistWriter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+// Create a directory, treating an existing one as success
+static bool makeDirectory(const std::string& path) {
+    if (mkdir(path.c_str(), 0755) == 0 || errno == EEXIST) {
+        return true;
+    }
+    std::cerr << "Error: Could not create directory " << path << ": " << std::strerror(errno) << std::endl;
+    return false;
+}
+
+EstimatorPool::EstimatorPool(const Netlist& netlist, const CellTable& cellTable, const std::string& cellLibraryFile,
+                             const std::string& costEstimator, const std::string& scratchDir, size_t numWorkers)
+    : netlist(netlist), cellTable(cellTable), cellLibraryFile(cellLibraryFile), costEstimator(costEstimator), started(0), stopping(false), spawnFailed(false) {
+    if (numWorkers == 0) {
+        numWorkers = 1;
+    }
+    if (!makeDirectory(scratchDir)) {
+        exit(1);
+    }
+
+    const std::string mockPrefix = "builtin:mock";
+    if (costEstimator.compare(0, mockPrefix.size(), mockPrefix) == 0) {
+        MockCostConfig mockConfig;
+        if (costEstimator.size() > mockPrefix.size() &&
+            (costEstimator[mockPrefix.size()] != ':' || !mockConfig.parseSpec(costEstimator.substr(mockPrefix.size() + 1)))) {
+            std::cerr << "Error: Invalid built-in estimator " << costEstimator << std::endl;
+            exit(1);
+        }
+        std::vector<Cell> cells;
+        for (size_t i = 0; i < cellTable.numCells(); ++i) {
+            cells.push_back(cellTable.cell(static_cast<uint16_t>(i)));
+        }
+        mockEstimator.reset(new MockCostEstimator(cells, mockConfig));
+    }
+
+    workers.resize(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        Worker& worker = workers[i];
+        worker.directory = scratchDir + "/worker_" + std::to_string(i);
+        if (!makeDirectory(worker.directory)) {
+            exit(1);
+        }
+        worker.candidateFile = worker.directory + "/candidate.v";
+        worker.costFile = worker.directory + "/cost.txt";
+        worker.logFile = worker.directory + "/estimator.log";
+        std::ofstream(worker.logFile, std::ios::trunc);
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers[i].thread = std::thread(&EstimatorPool::workerLoop, this, i);
+    }
+}
+
+EstimatorPool::~EstimatorPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+}
+
+size_t EstimatorPool::size() const {
+    return workers.size();
+}
+
+EvaluationMetrics& EstimatorPool::metrics() {
+    return evaluationMetrics;
+}
+
+size_t EstimatorPool::evaluations() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return started;
+}
+
+size_t EstimatorPool::committedEvaluations() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return started + tasks.size();
+}
+
+void EstimatorPool::restoreEvaluations(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    started = count;
+}
+
+const MockCostConfig* EstimatorPool::mockConfig() const {
+    return mockEstimator ? &mockEstimator->configuration() : nullptr;
+}
+
+bool EstimatorPool::failed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return spawnFailed;
+}
+
+float EstimatorPool::evaluate(const CellAssignment& mapping) {
+    return submit(mapping, false).get();
+}
+
+std::future<float> EstimatorPool::evaluateAsync(const CellAssignment& mapping) {
+    return submit(mapping, true);
+}
+
+size_t EstimatorPool::cancelPending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t queued = tasks.size();
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [](const Task& task) { return task.cancellable; }), tasks.end());
+    return queued - tasks.size();
+}
+
+std::future<float> EstimatorPool::submit(const CellAssignment& mapping, bool cancellable) {
+    std::shared_ptr<std::promise<float>> promise = std::make_shared<std::promise<float>>();
+    std::future<float> future = promise->get_future();
+    Task task;
+    task.mapping = mapping;
+    task.onDone = [promise](float cost) { promise->set_value(cost); };
+    task.cancellable = cancellable;
+    enqueue(std::move(task));
+    return future;
+}
+
+void EstimatorPool::submitBatch(const std::vector<CellAssignment>& mappings) {
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        Task task;
+        task.mapping = mappings[i];
+        task.onDone = [this, i](float cost) {
+            std::lock_guard<std::mutex> lock(mutex);
+            EvaluationResult result;
+            result.id = i;
+            result.cost = cost;
+            results.push_back(result);
+            resultReady.notify_all();
+        };
+        task.cancellable = false;
+        enqueue(std::move(task));
+    }
+}
+
+EvaluationResult EstimatorPool::nextResult() {
+    std::unique_lock<std::mutex> lock(mutex);
+    resultReady.wait(lock, [this] { return !results.empty(); });
+    EvaluationResult result = results.front();
+    results.pop_front();
+    return result;
+}
+
+std::vector<float> EstimatorPool::evaluateBatch(const std::vector<CellAssignment>& mappings) {
+    std::vector<float> costs(mappings.size(), std::numeric_limits<float>::max());
+    submitBatch(mappings);
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        EvaluationResult result = nextResult();
+        costs[result.id] = result.cost;
+    }
+    return costs;
+}
+
+void EstimatorPool::enqueue(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskReady.notify_one();
+}
+
+void EstimatorPool::workerLoop(size_t index) {
+    const Worker& worker = workers[index];
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            started++;
+        }
+        float cost = runCostEstimator(worker, task.mapping);
+        task.onDone(cost);
+    }
+}
+
+float EstimatorPool::runCostEstimator(const Worker& worker, const CellAssignment& mapping) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point phaseStart = Clock::now();
+    Clock::time_point evaluationStart = phaseStart;
+
+    if (mockEstimator) {
+        std::vector<const Cell*> gateCells(mapping.size(), nullptr);
+        for (size_t i = 0; i < mapping.size(); ++i) {
+            if (mapping[i] != kNoCell) {
+                gateCells[i] = &cellTable.cell(mapping[i]);
+            }
+        }
+        float cost = mockEstimator->estimate(netlist, gateCells);
+        Clock::duration runtime = Clock::now() - evaluationStart;
+        evaluationMetrics.record(PHASE_RUN, runtime);
+        evaluationMetrics.record(PHASE_TOTAL, runtime);
+        return cost;
+    }
+
+    if (failed()) {
+        return std::numeric_limits<float>::max();
+    }
+
+    // Write the candidate netlist into the worker's scratch directory
+    NetlistWriter netlistWriter;
+    netlistWriter.writeNetlist(netlist, cellTable.names(), mapping.cells(), worker.candidateFile);
+
+    std::vector<std::string> args = {costEstimator, "-library", cellLibraryFile, "-netlist", worker.candidateFile,
+                                     "-output", worker.costFile};
+    {
+        std::ofstream log(worker.logFile, std::ios::app);
+        log << "Running command:";
+        for (const auto& arg : args) {
+            log << " " << arg;
+        }
+        log << std::endl;
+    }
+
+    // Spawn the estimator with its stdout and stderr appended to the worker log
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 2, worker.logFile.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    posix_spawn_file_actions_adddup2(&actions, 2, 1);
+
+    std::remove(worker.costFile.c_str());
+    Clock::time_point now = Clock::now();
+    evaluationMetrics.record(PHASE_WRITE, now - phaseStart);
+    phaseStart = now;
+
+    pid_t pid;
+    int status = 0;
+    // posix_spawnp searches PATH for an estimator given without a directory, as system() did
+    int spawnError = posix_spawnp(&pid, costEstimator.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (spawnError != 0) {
+        // A missing or non-executable estimator does not recover, so the search has to stop
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!spawnFailed) {
+            spawnFailed = true;
+            std::cerr << "Error: Could not run cost estimator " << costEstimator << ": " << std::strerror(spawnError) << std::endl;
+        }
+        return std::numeric_limits<float>::max();
+    }
+    now = Clock::now();
+    evaluationMetrics.record(PHASE_SPAWN, now - phaseStart);
+    phaseStart = now;
+
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    now = Clock::now();
+    evaluationMetrics.record(PHASE_RUN, now - phaseStart);
+    phaseStart = now;
+
+    std::ifstream costFile(worker.costFile);
+    float cost = std::numeric_limits<float>::max();
+    if (costFile.is_open()) {
+        std::string line;
+        std::getline(costFile, line);
+        try {
+            size_t pos = line.find('=');
+            if (pos != std::string::npos) {
+                cost = std::stof(line.substr(pos + 1));
+            } else {
+                std::cerr << "Error: Could not find '=' in cost output." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Exception parsing cost: " << e.what() << std::endl;
+        }
+        costFile.close();
+    } else {
+        std::cerr << "Error: Could not open cost file " << worker.costFile << "." << std::endl;
+    }
+
+    now = Clock::now();
+    evaluationMetrics.record(PHASE_PARSE, now - phaseStart);
+    evaluationMetrics.record(PHASE_TOTAL, now - evaluationStart);
+    return cost;
+}
@@ -0,0 +1,103 @@
+#ifndef ESTIMATOR_POOL_HPP
+#define ESTIMATOR_POOL_HPP
+
+#include "NetlistParser.hpp"
+#include "CellAssignment.hpp"
+#include "EvaluationMetrics.hpp"
+#include "MockCostEstimator.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct EvaluationResult {
+    size_t id;   // Position of the candidate in the submitted batch
+    float cost;
+};
+
+// Runs the external cost estimator on K workers. Every worker owns a scratch
+// directory holding its candidate netlist, cost file and estimator log, so
+// several estimator processes can run side by side. An estimator named "builtin:mock" (optionally
+// followed by ":<options>", see MockCostConfig) is evaluated in-process instead.
+class EstimatorPool {
+public:
+    EstimatorPool(const Netlist& netlist, const CellTable& cellTable, const std::string& cellLibraryFile, const std::string& costEstimator,
+                  const std::string& scratchDir, size_t numWorkers);
+    ~EstimatorPool();
+
+    size_t size() const;
+    EvaluationMetrics& metrics();
+    // Estimator runs started so far; requests dropped before reaching a worker are not counted
+    size_t evaluations() const;
+    // Estimator runs started so far plus the requests still queued for a worker
+    size_t committedEvaluations() const;
+    // Continue the count of a resumed run
+    void restoreEvaluations(size_t count);
+    // True once the estimator could not be started, e.g. because it does not exist or is not
+    // executable; later requests then fail without running it
+    bool failed() const;
+    // Options of the in-process mock estimator, nullptr for an external estimator
+    const MockCostConfig* mockConfig() const;
+
+    // Evaluate a single assignment and wait for its cost
+    float evaluate(const CellAssignment& mapping);
+
+    // Queue a mapping and return a future for its cost. Requests that have not reached a worker yet
+    // can be dropped with cancelPending(); their promises are destroyed, so get() on the future of a
+    // dropped request throws std::future_error (broken_promise). Discard those futures unread.
+    std::future<float> evaluateAsync(const CellAssignment& mapping);
+    size_t cancelPending();
+
+    // Queue a batch of mappings; costs are collected with nextResult() in the order workers finish.
+    // Results of all submitted batches share one queue, so a pool is meant to have a single consumer.
+    void submitBatch(const std::vector<CellAssignment>& mappings);
+    EvaluationResult nextResult();
+
+    // Evaluate a batch and return the costs in submission order
+    std::vector<float> evaluateBatch(const std::vector<CellAssignment>& mappings);
+
+private:
+    struct Task {
+        CellAssignment mapping;
+        std::function<void(float)> onDone;
+        bool cancellable;
+    };
+
+    struct Worker {
+        std::string directory;
+        std::string candidateFile;
+        std::string costFile;
+        std::string logFile;
+        std::thread thread;
+    };
+
+    const Netlist& netlist;
+    const CellTable& cellTable;
+    std::string cellLibraryFile;
+    std::string costEstimator;
+    std::vector<Worker> workers;
+    std::unique_ptr<MockCostEstimator> mockEstimator;
+    EvaluationMetrics evaluationMetrics;
+
+    std::deque<Task> tasks;
+    std::deque<EvaluationResult> results;
+    size_t started;
+    bool stopping;
+    bool spawnFailed;
+    mutable std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable resultReady;
+
+    void enqueue(Task task);
+    std::future<float> submit(const CellAssignment& mapping, bool cancellable);
+    void workerLoop(size_t index);
+    float runCostEstimator(const Worker& worker, const CellAssignment& mapping);
+};
+
+#endif // ESTIMATOR_POOL_HPP
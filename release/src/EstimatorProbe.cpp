@@ -0,0 +1,333 @@
+#include "EstimatorProbe.hpp"
+#include "NetlistGraph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+
+static const size_t kMinCriticalPairs = 3;  // Pairs of the largest single changes needed to call a cost additive
+static const double kRoundingUlps = 4.0;    // Float rounding of the four costs a pair residual combines
+static const double kAdditiveFraction = 1e-3;  // Largest residual of an additive cost, relative to the median single change
+
+// Pairs of the critical-path set, which also bounds its extra single changes
+static size_t criticalPairCount(size_t numPairs) {
+    return std::max(numPairs / 2, kMinCriticalPairs);
+}
+
+EstimatorProbe::EstimatorProbe(const Netlist& netlist, const CellTable& cellTable, const BatchEvaluator& evaluate, size_t numPairs,
+                               const Random& random)
+    : netlist(netlist), cellTable(cellTable), evaluate(evaluate), numPairs(numPairs), random(random), fanouts(netlist.gates.size()) {
+    std::unordered_map<std::string, size_t> driver;
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        driver[netlist.gates[i].output] = i;
+    }
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        for (const auto& input : netlist.gates[i].inputs) {
+            auto it = driver.find(input);
+            if (it != driver.end()) {
+                fanouts[it->second].push_back(i);
+            }
+        }
+    }
+}
+
+size_t EstimatorProbe::maxEvaluations(size_t numPairs) {
+    // Two single changes per random pair and one per critical gate, a twin for each of those, the
+    // random pairs and the critical pairs
+    size_t numCritical = criticalPairCount(numPairs);
+    return 2 * (2 * numPairs + numCritical) + numPairs + numCritical;
+}
+
+const char* EstimatorProbe::modelName(CostModelKind model) {
+    switch (model) {
+    case COST_MODEL_ADDITIVE:
+        return "additive";
+    case COST_MODEL_PAIRWISE:
+        return "pairwise";
+    case COST_MODEL_MAX_PATH:
+        return "max-path";
+    default:
+        return "unknown";
+    }
+}
+
+bool EstimatorProbe::randomAlternative(size_t gate, const CellAssignment& baseAssignment, uint16_t& cell) {
+    const std::vector<uint16_t>& options = cellTable.candidates(gate);
+    if (options.size() < 2 || baseAssignment[gate] == kNoCell) {
+        return false;
+    }
+    do {
+        cell = options[random.below(options.size())];
+    } while (cell == baseAssignment[gate]);
+    return true;
+}
+
+bool EstimatorProbe::adjacent(size_t a, size_t b) const {
+    return std::find(fanouts[a].begin(), fanouts[a].end(), b) != fanouts[a].end() ||
+           std::find(fanouts[b].begin(), fanouts[b].end(), a) != fanouts[b].end();
+}
+
+ProbeReport EstimatorProbe::run(const CellAssignment& baseAssignment, float baseCost) {
+    ProbeReport report;
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        if (cellTable.candidates(i).size() > 1 && baseAssignment[i] != kNoCell) {
+            candidates.push_back(i);
+        }
+    }
+    if (candidates.size() < 2) {
+        return report;
+    }
+
+    // Design the experiment: pairs of changes, half of them on directly connected gates, and the
+    // single changes they consist of
+    std::vector<std::pair<size_t, uint16_t>> singles;
+    std::map<std::pair<size_t, uint16_t>, size_t> singleIndex;
+    auto addSingle = [&](size_t gate, uint16_t cell) -> size_t {
+        std::pair<size_t, uint16_t> move(gate, cell);
+        auto it = singleIndex.find(move);
+        if (it != singleIndex.end()) {
+            return it->second;
+        }
+        singleIndex[move] = singles.size();
+        singles.push_back(move);
+        return singles.size() - 1;
+    };
+
+    struct PairProbe {
+        size_t first;
+        size_t second;
+        bool adjacent;
+    };
+    std::vector<PairProbe> pairs;
+    for (size_t p = 0; p < numPairs; ++p) {
+        size_t a = candidates[random.below(candidates.size())];
+        size_t b = a;
+        if (p % 2 == 0) {
+            std::vector<size_t> options;
+            for (size_t fanout : fanouts[a]) {
+                if (cellTable.candidates(fanout).size() > 1 && baseAssignment[fanout] != kNoCell) {
+                    options.push_back(fanout);
+                }
+            }
+            if (!options.empty()) {
+                b = options[random.below(options.size())];
+            }
+        }
+        while (b == a) {
+            b = candidates[random.below(candidates.size())];
+        }
+        uint16_t cellA = kNoCell, cellB = kNoCell;
+        randomAlternative(a, baseAssignment, cellA);
+        randomAlternative(b, baseAssignment, cellB);
+        PairProbe pair;
+        pair.first = addSingle(a, cellA);
+        pair.second = addSingle(b, cellB);
+        pair.adjacent = adjacent(a, b);
+        pairs.push_back(pair);
+    }
+
+    // Changes on gates of a structurally longest path, which a max-path term is most likely to see
+    NetlistGraph graph(netlist);
+    std::vector<size_t> height(netlist.gates.size(), 0);
+    size_t longest = 0;
+    for (auto it = graph.order().rbegin(); it != graph.order().rend(); ++it) {
+        for (size_t fanout : graph.fanouts(*it)) {
+            height[*it] = std::max(height[*it], height[fanout] + 1);
+        }
+        longest = std::max(longest, graph.level(*it) + height[*it]);
+    }
+    std::vector<size_t> critical;
+    for (size_t gate : candidates) {
+        if (graph.level(gate) + height[gate] == longest) {
+            critical.push_back(gate);
+        }
+    }
+    size_t numCritical = criticalPairCount(numPairs);
+    for (size_t c = 0; c < critical.size() && c < numCritical; ++c) {
+        std::swap(critical[c], critical[c + random.below(critical.size() - c)]);
+        uint16_t cell = kNoCell;
+        randomAlternative(critical[c], baseAssignment, cell);
+        addSingle(critical[c], cell);
+    }
+    critical.resize(std::min(critical.size(), numCritical));
+    std::sort(critical.begin(), critical.end());
+
+    // Apply the same cell change to a second gate of the same type and base cell
+    std::vector<std::pair<size_t, size_t>> twins;
+    size_t numSingles = singles.size();
+    for (size_t s = 0; s < numSingles; ++s) {
+        size_t gate = singles[s].first;
+        uint16_t baseCell = baseAssignment[gate];
+        for (int attempt = 0; attempt < 50; ++attempt) {
+            size_t other = candidates[random.below(candidates.size())];
+            if (other != gate && netlist.gates[other].type == netlist.gates[gate].type &&
+                baseAssignment[other] == baseCell) {
+                twins.push_back(std::make_pair(s, addSingle(other, singles[s].second)));
+                break;
+            }
+        }
+    }
+
+    // Evaluate every perturbation as one batch
+    std::vector<CellAssignment> assignments;
+    for (const auto& single : singles) {
+        assignments.push_back(baseAssignment);
+        assignments.back().set(single.first, single.second);
+    }
+    for (const auto& pair : pairs) {
+        assignments.push_back(baseAssignment);
+        assignments.back().set(singles[pair.first].first, singles[pair.first].second);
+        assignments.back().set(singles[pair.second].first, singles[pair.second].second);
+    }
+    std::vector<float> costs = evaluate(assignments);
+    report.evaluations = costs.size();
+
+    auto valid = [](float cost) { return cost < std::numeric_limits<float>::max(); };
+    std::vector<double> deltas(singles.size(), 0.0);
+    for (size_t s = 0; s < singles.size(); ++s) {
+        deltas[s] = static_cast<double>(costs[s]) - baseCost;
+        if (valid(costs[s])) {
+            ProbeMove move;
+            move.gate = singles[s].first;
+            move.cell = singles[s].second;
+            move.delta = static_cast<float>(deltas[s]);
+            report.singles.push_back(move);
+        }
+    }
+
+    // The estimator gives no delays, so the critical path is taken to run through the gates of the
+    // longest paths and those whose single changes moved the cost most; pair those up
+    std::vector<size_t> ranked;
+    for (size_t s = 0; s < singles.size(); ++s) {
+        if (valid(costs[s]) && deltas[s] != 0.0) {
+            ranked.push_back(s);
+        }
+    }
+    auto onLongestPath = [&](size_t s) { return std::binary_search(critical.begin(), critical.end(), singles[s].first); };
+    std::sort(ranked.begin(), ranked.end(), [&](size_t x, size_t y) {
+        if (onLongestPath(x) != onLongestPath(y)) {
+            return onLongestPath(x);
+        }
+        return std::fabs(deltas[x]) > std::fabs(deltas[y]);
+    });
+    size_t top = 2;
+    while (top < ranked.size() && top * (top - 1) / 2 < numCritical) {
+        top++;
+    }
+    ranked.resize(std::min(2 * top, ranked.size()));
+    // Changes on one path add up even under a max-path term, so pairs on separate paths go first
+    std::vector<std::vector<size_t>> cones;
+    for (size_t s : ranked) {
+        cones.push_back(graph.fanoutCone(singles[s].first, 0));
+        std::sort(cones.back().begin(), cones.back().end());
+    }
+    auto separate = [&](size_t i, size_t j) {
+        return !std::binary_search(cones[i].begin(), cones[i].end(), singles[ranked[j]].first) &&
+               !std::binary_search(cones[j].begin(), cones[j].end(), singles[ranked[i]].first);
+    };
+    size_t numRandomPairs = pairs.size();
+    std::vector<CellAssignment> criticalAssignments;
+    std::vector<std::vector<bool>> paired(ranked.size(), std::vector<bool>(ranked.size(), false));
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < ranked.size() && pairs.size() - numRandomPairs < numCritical; ++i) {
+            for (size_t j = i + 1; j < ranked.size() && pairs.size() - numRandomPairs < numCritical; ++j) {
+                size_t a = singles[ranked[i]].first;
+                size_t b = singles[ranked[j]].first;
+                if (a == b || paired[i][j] || (pass == 0 && !separate(i, j))) {
+                    continue;
+                }
+                paired[i][j] = true;
+                PairProbe pair;
+                pair.first = ranked[i];
+                pair.second = ranked[j];
+                pair.adjacent = adjacent(a, b);
+                pairs.push_back(pair);
+                criticalAssignments.push_back(baseAssignment);
+                criticalAssignments.back().set(a, singles[ranked[i]].second);
+                criticalAssignments.back().set(b, singles[ranked[j]].second);
+            }
+        }
+    }
+    if (!criticalAssignments.empty()) {
+        std::vector<float> criticalCosts = evaluate(criticalAssignments);
+        costs.insert(costs.end(), criticalCosts.begin(), criticalCosts.end());
+        report.evaluations += criticalCosts.size();
+    }
+
+    // Fit the pair interactions r = d(ab) - d(a) - d(b) with each model
+    std::vector<double> residuals, adjacency, saturation;
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        const PairProbe& pair = pairs[p];
+        float pairCost = costs[singles.size() + p];
+        if (!valid(pairCost) || !valid(costs[pair.first]) || !valid(costs[pair.second])) {
+            continue;
+        }
+        if (p >= numRandomPairs) {
+            report.criticalPairs++;
+        }
+        double da = deltas[pair.first];
+        double db = deltas[pair.second];
+        residuals.push_back(static_cast<double>(pairCost) - baseCost - da - db);
+        adjacency.push_back(pair.adjacent ? 1.0 : 0.0);
+        // A max over paths only counts the larger of two increases on different paths
+        saturation.push_back(da > 0 && db > 0 ? -std::min(da, db) : 0.0);
+    }
+    if (residuals.empty()) {
+        return report;
+    }
+
+    auto rmsAfterFit = [&](const std::vector<double>& basis) -> double {
+        double dot = 0.0, norm = 0.0;
+        for (size_t i = 0; i < residuals.size(); ++i) {
+            dot += basis[i] * residuals[i];
+            norm += basis[i] * basis[i];
+        }
+        double theta = norm > 0.0 ? dot / norm : 0.0;
+        double sum = 0.0;
+        for (size_t i = 0; i < residuals.size(); ++i) {
+            double error = residuals[i] - theta * basis[i];
+            sum += error * error;
+        }
+        return std::sqrt(sum / residuals.size());
+    };
+    std::vector<double> zero(residuals.size(), 0.0);
+    report.additiveError = rmsAfterFit(zero);
+    report.pairwiseError = rmsAfterFit(adjacency);
+    report.maxPathError = rmsAfterFit(saturation);
+
+    // The residuals of an additive cost are rounding only, a few ulps of the cost. Residuals that small
+    // relative to the whole cost still hide a max-path term, which moves only some of the pairs by a
+    // fraction of a single change, so every residual has to be far below the single changes as well
+    float magnitude = std::fabs(baseCost);
+    double ulp = static_cast<double>(std::nextafter(magnitude, std::numeric_limits<float>::max())) - magnitude;
+    std::vector<double> changes;
+    for (size_t s = 0; s < singles.size(); ++s) {
+        if (valid(costs[s]) && deltas[s] != 0.0) {
+            changes.push_back(std::fabs(deltas[s]));
+        }
+    }
+    std::nth_element(changes.begin(), changes.begin() + changes.size() / 2, changes.end());
+    double medianChange = changes.empty() ? 0.0 : changes[changes.size() / 2];
+    double tolerance = std::min(kRoundingUlps * ulp, kAdditiveFraction * medianChange);
+    double largestResidual = 0.0;
+    for (double residual : residuals) {
+        largestResidual = std::max(largestResidual, std::fabs(residual));
+    }
+    report.tolerance = tolerance;
+    if (largestResidual <= tolerance && report.criticalPairs >= kMinCriticalPairs) {
+        report.model = COST_MODEL_ADDITIVE;
+    } else if (std::min(report.pairwiseError, report.maxPathError) <= 0.5 * report.additiveError) {
+        report.model = report.pairwiseError <= report.maxPathError ? COST_MODEL_PAIRWISE : COST_MODEL_MAX_PATH;
+    }
+
+    report.positionIndependent = !twins.empty();
+    for (const auto& twin : twins) {
+        if (!valid(costs[twin.first]) || !valid(costs[twin.second]) || std::fabs(deltas[twin.first] - deltas[twin.second]) > tolerance) {
+            report.positionIndependent = false;
+        }
+    }
+    return report;
+}
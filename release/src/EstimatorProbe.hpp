@@ -0,0 +1,64 @@
+#ifndef ESTIMATOR_PROBE_HPP
+#define ESTIMATOR_PROBE_HPP
+
+#include "CellAssignment.hpp"
+#include "NetlistParser.hpp"
+#include "Random.hpp"
+#include <vector>
+
+enum CostModelKind {
+    COST_MODEL_ADDITIVE,   // Cost is a sum of independent per-gate terms
+    COST_MODEL_PAIRWISE,   // Additive plus interactions between connected gates
+    COST_MODEL_MAX_PATH,   // Additive plus a max-over-paths (timing-like) term
+    COST_MODEL_UNKNOWN     // None of the models explains the measurements
+};
+
+// A single-gate change of the probe's base mapping and the cost difference it caused
+struct ProbeMove {
+    size_t gate;
+    uint16_t cell;
+    float delta;
+};
+
+struct ProbeReport {
+    CostModelKind model = COST_MODEL_UNKNOWN;
+    bool positionIndependent = false;  // The same cell change costs the same on every gate of a type
+    double additiveError = 0.0;        // RMS error of each model on the pair perturbations
+    double pairwiseError = 0.0;
+    double maxPathError = 0.0;
+    size_t criticalPairs = 0;          // Valid pairs of the largest single changes
+    double tolerance = 0.0;            // Largest pair residual or twin difference taken for rounding
+    size_t evaluations = 0;
+    std::vector<ProbeMove> singles;
+};
+
+// Runs a designed set of single- and pair-gate perturbations against the estimator and fits
+// additive, pairwise and max-path models to the pair interactions. Random pairs mostly miss the
+// critical path, where a max-path term interacts, so a second set pairs up the single changes that
+// moved the cost most; the cost is only called additive if enough of those pairs were measured.
+class EstimatorProbe {
+public:
+    // The evaluator may fail mappings with the float maximum, e.g. past an evaluation limit; the fits
+    // leave those out
+    EstimatorProbe(const Netlist& netlist, const CellTable& cellTable, const BatchEvaluator& evaluate, size_t numPairs, const Random& random);
+
+    ProbeReport run(const CellAssignment& baseAssignment, float baseCost);
+
+    // Upper bound on the mappings a probe with the given number of pairs evaluates
+    static size_t maxEvaluations(size_t numPairs);
+
+    static const char* modelName(CostModelKind model);
+
+private:
+    const Netlist& netlist;
+    const CellTable& cellTable;
+    BatchEvaluator evaluate;
+    size_t numPairs;
+    Random random;
+    std::vector<std::vector<size_t>> fanouts;
+
+    bool randomAlternative(size_t gate, const CellAssignment& baseAssignment, uint16_t& cell);
+    bool adjacent(size_t a, size_t b) const;
+};
+
+#endif // ESTIMATOR_PROBE_HPP
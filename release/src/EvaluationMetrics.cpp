@@ -0,0 +1,129 @@
+#include "EvaluationMetrics.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+
+static const char* const kPhaseNames[PHASE_COUNT] = {"write", "spawn", "run", "parse", "total"};
+
+LatencyHistogram::LatencyHistogram() : buckets((64 - kSubBucketBits + 1) << kSubBucketBits, 0), total(0), sum(0), maxValue(0) {}
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+    const uint64_t subBuckets = 1ULL << kSubBucketBits;
+    if (micros < subBuckets) {
+        return static_cast<size_t>(micros);
+    }
+    int exponent = 63 - __builtin_clzll(micros);
+    int shift = exponent - kSubBucketBits;
+    return static_cast<size_t>((shift + 1) * subBuckets + ((micros >> shift) - subBuckets));
+}
+
+uint64_t LatencyHistogram::bucketValue(size_t index) {
+    const uint64_t subBuckets = 1ULL << kSubBucketBits;
+    if (index < subBuckets) {
+        return index;
+    }
+    int shift = static_cast<int>(index / subBuckets) - 1;
+    uint64_t lower = (subBuckets + index % subBuckets) << shift;
+    return lower + ((1ULL << shift) >> 1);  // Middle of the bucket
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    buckets[bucketIndex(micros)]++;
+    total++;
+    sum += micros;
+    if (micros > maxValue) {
+        maxValue = micros;
+    }
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total;
+}
+
+double LatencyHistogram::mean() const {
+    return total == 0 ? 0.0 : static_cast<double>(sum) / total;
+}
+
+uint64_t LatencyHistogram::max() const {
+    return maxValue;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(p / 100.0 * total));
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return std::min(bucketValue(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+EvaluationMetrics::EvaluationMetrics() : start(std::chrono::steady_clock::now()) {}
+
+void EvaluationMetrics::record(EvaluationPhase phase, std::chrono::steady_clock::duration duration) {
+    long long micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    histograms[phase].record(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+}
+
+void EvaluationMetrics::setCounter(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters[name] = value;
+}
+
+double EvaluationMetrics::meanSeconds(EvaluationPhase phase) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return histograms[phase].mean() * 1e-6;
+}
+
+void EvaluationMetrics::writeJson(const std::string& path, const std::string& costEstimator) const {
+    json report;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        uint64_t evaluations = histograms[PHASE_TOTAL].count();
+        report["cost_estimator"] = costEstimator;
+        report["elapsed_seconds"] = elapsed;
+        report["evaluations"] = evaluations;
+        report["evaluations_per_second"] = elapsed > 0 ? evaluations / elapsed : 0.0;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            const LatencyHistogram& histogram = histograms[phase];
+            json entry;
+            entry["count"] = histogram.count();
+            entry["mean_us"] = histogram.mean();
+            entry["p50_us"] = histogram.percentile(50);
+            entry["p90_us"] = histogram.percentile(90);
+            entry["p99_us"] = histogram.percentile(99);
+            entry["max_us"] = histogram.max();
+            report["phases"][kPhaseNames[phase]] = entry;
+        }
+        for (const auto& counter : counters) {
+            report["counters"][counter.first] = counter.second;
+        }
+    }
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not write metrics file " << tempPath << std::endl;
+        return;
+    }
+    out << report.dump(4) << std::endl;
+    out.close();
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not replace metrics file " << path << std::endl;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef EVALUATION_METRICS_HPP
+#define EVALUATION_METRICS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Log-linear (HDR-style) histogram of durations in microseconds. Each power of two is split
+// into 32 sub-buckets, so recorded values keep about 3% relative precision at any scale.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t micros);
+    uint64_t count() const;
+    double mean() const;
+    uint64_t max() const;
+    uint64_t percentile(double p) const;
+
+private:
+    static const int kSubBucketBits = 5;
+
+    std::vector<uint64_t> buckets;
+    uint64_t total;
+    uint64_t sum;
+    uint64_t maxValue;
+
+    static size_t bucketIndex(uint64_t micros);
+    static uint64_t bucketValue(size_t index);
+};
+
+enum EvaluationPhase {
+    PHASE_WRITE,   // Writing the candidate netlist
+    PHASE_SPAWN,   // Starting the estimator process
+    PHASE_RUN,     // Waiting for the estimator to finish
+    PHASE_PARSE,   // Reading the cost back
+    PHASE_TOTAL,   // Whole evaluation
+    PHASE_COUNT
+};
+
+// Per-phase latency of estimator invocations, shared by all pool workers
+class EvaluationMetrics {
+public:
+    EvaluationMetrics();
+
+    void record(EvaluationPhase phase, std::chrono::steady_clock::duration duration);
+    void setCounter(const std::string& name, double value);
+    // Mean duration of a phase so far, 0 before the first record
+    double meanSeconds(EvaluationPhase phase) const;
+
+    // Write the histograms and throughput as JSON, replacing the file atomically
+    void writeJson(const std::string& path, const std::string& costEstimator) const;
+
+private:
+    mutable std::mutex mutex;
+    std::chrono::steady_clock::time_point start;
+    LatencyHistogram histograms[PHASE_COUNT];
+    std::map<std::string, double> counters;
+};
+
+#endif // EVALUATION_METRICS_HPP
@@ -0,0 +1,131 @@
+#include "GeneticSearch.hpp"
+#include <algorithm>
+
+GeneticSearch::GeneticSearch(const CellTable& cellTable, const NetlistGraph& graph, const BatchEvaluator& evaluate,
+                             const GeneticConfig& config)
+    : cellTable(cellTable), graph(graph), evaluate(evaluate), config(config), evaluationCount(0) {
+    this->config.populationSize = std::max<size_t>(config.populationSize, 2);
+    this->config.eliteCount = std::min(config.eliteCount, this->config.populationSize - 1);
+    this->config.tournamentSize = std::max<size_t>(config.tournamentSize, 1);
+    for (size_t i = 0; i < cellTable.numGates(); ++i) {
+        if (cellTable.candidates(i).size() > 1) {
+            movableGates.push_back(i);
+        }
+    }
+}
+
+void GeneticSearch::initialize(const CellAssignment& seed, float seedCost, Random& random) {
+    population.clear();
+    Individual first;
+    first.assignment = seed;
+    first.cost = seedCost;
+    population.push_back(first);
+
+    // The rest of the population starts a few moves away from the seed
+    std::vector<Individual> mutants;
+    for (size_t i = 1; i < config.populationSize; ++i) {
+        Individual mutant;
+        mutant.assignment = seed;
+        size_t moves = 1 + random.below(std::max<size_t>(config.mutations * 4, 1));
+        for (size_t m = 0; m < moves; ++m) {
+            mutate(mutant.assignment, random);
+        }
+        mutants.push_back(mutant);
+    }
+    evaluateAndSort(mutants);
+}
+
+void GeneticSearch::generation(Random& random) {
+    std::vector<Individual> offspring;
+    for (size_t i = config.eliteCount; i < config.populationSize; ++i) {
+        const Individual& first = tournament(random);
+        Individual child;
+        if (random.uniform() < config.crossoverRate) {
+            child.assignment = crossover(first.assignment, tournament(random).assignment, random);
+        } else {
+            child.assignment = first.assignment;
+        }
+        for (size_t m = 0; m < config.mutations; ++m) {
+            mutate(child.assignment, random);
+        }
+        offspring.push_back(child);
+    }
+    // Elites survive as they are; the rest of the generation is replaced by the offspring
+    population.resize(config.eliteCount);
+    evaluateAndSort(offspring);
+}
+
+void GeneticSearch::evaluateAndSort(std::vector<Individual>& offspring) {
+    std::vector<CellAssignment> batch;
+    for (const auto& individual : offspring) {
+        batch.push_back(individual.assignment);
+    }
+    std::vector<float> costs = evaluate(batch);
+    evaluationCount += batch.size();
+    for (size_t i = 0; i < offspring.size(); ++i) {
+        offspring[i].cost = costs[i];
+        population.push_back(std::move(offspring[i]));
+    }
+    std::stable_sort(population.begin(), population.end(),
+                     [](const Individual& a, const Individual& b) { return a.cost < b.cost; });
+}
+
+const GeneticSearch::Individual& GeneticSearch::tournament(Random& random) const {
+    size_t winner = random.below(population.size());
+    for (size_t i = 1; i < config.tournamentSize; ++i) {
+        // The population is sorted, so the lower index is the fitter contestant
+        winner = std::min(winner, static_cast<size_t>(random.below(population.size())));
+    }
+    return population[winner];
+}
+
+CellAssignment GeneticSearch::crossover(const CellAssignment& first, const CellAssignment& second, Random& random) const {
+    CellAssignment child = first;
+    for (size_t c = 0; c < config.conesPerCrossover; ++c) {
+        size_t root = random.below(graph.numGates());
+        for (size_t gate : graph.faninCone(root, config.coneDepth)) {
+            child.set(gate, second[gate]);
+        }
+    }
+    return child;
+}
+
+void GeneticSearch::mutate(CellAssignment& assignment, Random& random) const {
+    if (movableGates.empty()) {
+        return;
+    }
+    size_t gate = movableGates[random.below(movableGates.size())];
+    const std::vector<uint16_t>& cells = cellTable.candidates(gate);
+    uint16_t newCell = cells[random.below(cells.size() - 1)];
+    if (newCell == assignment[gate]) {
+        newCell = cells.back();
+    }
+    assignment.set(gate, newCell);
+}
+
+const CellAssignment& GeneticSearch::best() const {
+    return population.front().assignment;
+}
+
+float GeneticSearch::bestCost() const {
+    return population.front().cost;
+}
+
+size_t GeneticSearch::evaluations() const {
+    return evaluationCount;
+}
+
+double GeneticSearch::diversity() const {
+    if (population.size() < 2 || best().size() == 0) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (size_t i = 1; i < population.size(); ++i) {
+        size_t differing = 0;
+        for (size_t g = 0; g < best().size(); ++g) {
+            differing += population[i].assignment[g] != best()[g] ? 1 : 0;
+        }
+        total += static_cast<double>(differing) / best().size();
+    }
+    return total / (population.size() - 1);
+}
@@ -0,0 +1,57 @@
+#ifndef GENETIC_SEARCH_HPP
+#define GENETIC_SEARCH_HPP
+
+#include "CellAssignment.hpp"
+#include "NetlistGraph.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <vector>
+
+struct GeneticConfig {
+    size_t populationSize = 32;
+    size_t eliteCount = 2;          // Best individuals copied unchanged into the next generation
+    size_t tournamentSize = 3;
+    double crossoverRate = 0.9;
+    size_t coneDepth = 4;           // Levels of the fanin cones exchanged by crossover
+    size_t conesPerCrossover = 2;
+    size_t mutations = 1;           // Single-gate moves applied to every offspring
+};
+
+// Generational genetic algorithm over cell assignments. Crossover copies whole fanin cones from the
+// second parent into the first, so gates that drive each other keep cells that were costed together.
+// Mutation is the single random gate, random different cell move of the annealer. Every generation's
+// offspring are evaluated as one batch.
+class GeneticSearch {
+public:
+    GeneticSearch(const CellTable& cellTable, const NetlistGraph& graph, const BatchEvaluator& evaluate, const GeneticConfig& config);
+
+    // Seed the population with the assignment and mutants of it
+    void initialize(const CellAssignment& seed, float seedCost, Random& random);
+    void generation(Random& random);
+
+    const CellAssignment& best() const;
+    float bestCost() const;
+    size_t evaluations() const;
+    double diversity() const;  // Mean fraction of gates that differ from the best individual
+
+private:
+    struct Individual {
+        CellAssignment assignment;
+        float cost;
+    };
+
+    const CellTable& cellTable;
+    const NetlistGraph& graph;
+    BatchEvaluator evaluate;
+    GeneticConfig config;
+    std::vector<Individual> population;  // Sorted by cost, best first
+    std::vector<size_t> movableGates;
+    size_t evaluationCount;
+
+    const Individual& tournament(Random& random) const;
+    CellAssignment crossover(const CellAssignment& first, const CellAssignment& second, Random& random) const;
+    void mutate(CellAssignment& assignment, Random& random) const;
+    void evaluateAndSort(std::vector<Individual>& offspring);
+};
+
+#endif // GENETIC_SEARCH_HPP
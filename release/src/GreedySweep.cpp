@@ -0,0 +1,126 @@
+#include "GreedySweep.hpp"
+#include <algorithm>
+#include <limits>
+
+GreedySweep::GreedySweep(const CellTable& cellTable, const BatchEvaluator& evaluate, size_t maxRounds)
+    : cellTable(cellTable), evaluate(evaluate), maxRounds(maxRounds), evaluationCount(0), roundCount(0),
+      typeGates(cellTable.numTypes()) {
+    for (size_t i = 0; i < cellTable.numGates(); ++i) {
+        typeGates[cellTable.typeOf(i)].push_back(i);
+    }
+}
+
+size_t GreedySweep::evaluations() const {
+    return evaluationCount;
+}
+
+size_t GreedySweep::rounds() const {
+    return roundCount;
+}
+
+CellAssignment GreedySweep::withTypeCell(const CellAssignment& assignment, const std::vector<size_t>& gates, uint16_t cell) {
+    CellAssignment result = assignment;
+    for (size_t gate : gates) {
+        result.set(gate, cell);
+    }
+    return result;
+}
+
+void GreedySweep::run(CellAssignment& assignment, float& cost) {
+    std::vector<size_t> types;
+    for (size_t t = 1; t < cellTable.numTypes(); ++t) {
+        if (cellTable.typeCells(t).size() > 1 && !typeGates[t].empty()) {
+            types.push_back(t);
+        }
+    }
+    if (types.empty()) {
+        return;
+    }
+
+    // Screening: one batch covering every (type, cell) pair against the entry assignment
+    std::vector<CellAssignment> screen;
+    for (size_t t : types) {
+        for (uint16_t cell : cellTable.typeCells(t)) {
+            screen.push_back(withTypeCell(assignment, typeGates[t], cell));
+        }
+    }
+    std::vector<float> screenCosts = evaluate(screen);
+    evaluationCount += screen.size();
+
+    CellAssignment combined = assignment;
+    std::vector<float> spread(cellTable.numTypes(), 0.0f);
+    size_t offset = 0;
+    for (size_t t : types) {
+        const std::vector<uint16_t>& cells = cellTable.typeCells(t);
+        size_t best = 0;
+        float lowest = std::numeric_limits<float>::max();
+        float highest = std::numeric_limits<float>::lowest();
+        for (size_t c = 0; c < cells.size(); ++c) {
+            float value = screenCosts[offset + c];
+            if (value < lowest) {
+                lowest = value;
+                best = c;
+            }
+            if (value < std::numeric_limits<float>::max()) {
+                highest = std::max(highest, value);
+            }
+        }
+        spread[t] = highest > lowest ? highest - lowest : 0.0f;
+        if (lowest < cost) {
+            combined = withTypeCell(combined, typeGates[t], cells[best]);
+        }
+        offset += cells.size();
+    }
+
+    // The per-type choices were made independently, so keep the combination only if it actually helps
+    float combinedCost = evaluate(std::vector<CellAssignment>(1, combined))[0];
+    evaluationCount++;
+    if (combinedCost < cost) {
+        assignment = combined;
+        cost = combinedCost;
+    }
+    // Take the best single-type screening result too; it is known to be at least that good
+    offset = 0;
+    for (size_t t : types) {
+        const std::vector<uint16_t>& cells = cellTable.typeCells(t);
+        for (size_t c = 0; c < cells.size(); ++c) {
+            if (screenCosts[offset + c] < cost) {
+                cost = screenCosts[offset + c];
+                assignment = screen[offset + c];
+            }
+        }
+        offset += cells.size();
+    }
+
+    // Coordinate descent, visiting the types whose cell choice mattered most first
+    std::stable_sort(types.begin(), types.end(), [&](size_t a, size_t b) { return spread[a] > spread[b]; });
+    while (roundCount < maxRounds) {
+        roundCount++;
+        bool improved = false;
+        for (size_t t : types) {
+            const std::vector<uint16_t>& cells = cellTable.typeCells(t);
+            std::vector<CellAssignment> batch;
+            for (uint16_t cell : cells) {
+                CellAssignment candidate = withTypeCell(assignment, typeGates[t], cell);
+                if (!(candidate == assignment)) {
+                    batch.push_back(candidate);
+                }
+            }
+            if (batch.empty()) {
+                continue;
+            }
+            std::vector<float> costs = evaluate(batch);
+            evaluationCount += batch.size();
+            for (size_t i = 0; i < batch.size(); ++i) {
+                if (costs[i] < cost) {
+                    cost = costs[i];
+                    assignment = batch[i];
+                    improved = true;
+                }
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef GREEDY_SWEEP_HPP
+#define GREEDY_SWEEP_HPP
+
+#include "CellAssignment.hpp"
+#include <cstddef>
+#include <vector>
+
+// Builds a starting assignment from uniform per-type assignments. A screening pass maps every gate of
+// one type to one cell, for every type and cell, with the other types left as they are. Each type then
+// takes its best cell, and coordinate descent over the types refines the combination. All cells of a
+// type are evaluated as one batch, so the evaluator can run them side by side.
+class GreedySweep {
+public:
+    GreedySweep(const CellTable& cellTable, const BatchEvaluator& evaluate, size_t maxRounds);
+
+    // Improve assignment in place; cost is the cost of the assignment on entry and on return
+    void run(CellAssignment& assignment, float& cost);
+
+    size_t evaluations() const;
+    size_t rounds() const;
+
+private:
+    const CellTable& cellTable;
+    BatchEvaluator evaluate;
+    size_t maxRounds;
+    size_t evaluationCount;
+    size_t roundCount;
+    std::vector<std::vector<size_t>> typeGates;
+
+    static CellAssignment withTypeCell(const CellAssignment& assignment, const std::vector<size_t>& gates, uint16_t cell);
+};
+
+#endif // GREEDY_SWEEP_HPP
@@ -0,0 +1,214 @@
+#include "LogicSimulator.hpp"
+#include "NetlistGraph.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+enum WordOperation { WORD_AND, WORD_OR, WORD_XOR };
+
+GateFunction gateFunction(const std::string& type) {
+    static const std::unordered_map<std::string, GateFunction> functions = {
+        {"and", GATE_AND}, {"nand", GATE_NAND}, {"or", GATE_OR}, {"nor", GATE_NOR},
+        {"xor", GATE_XOR}, {"xnor", GATE_XNOR}, {"not", GATE_NOT}, {"buf", GATE_BUF}};
+    auto it = functions.find(type);
+    return it != functions.end() ? it->second : GATE_UNKNOWN;
+}
+
+// out = a op b, inverted if requested; out may alias a or b
+template <int Operation, bool Invert>
+static void wordKernel(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t w = 0;
+#ifdef __AVX2__
+    const __m256i mask = _mm256_set1_epi64x(Invert ? -1 : 0);
+    for (; w + 4 <= words; w += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+        __m256i r = Operation == WORD_AND ? _mm256_and_si256(x, y) : Operation == WORD_OR ? _mm256_or_si256(x, y) : _mm256_xor_si256(x, y);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), _mm256_xor_si256(r, mask));
+    }
+#endif
+    for (; w < words; ++w) {
+        uint64_t r = Operation == WORD_AND ? a[w] & b[w] : Operation == WORD_OR ? a[w] | b[w] : a[w] ^ b[w];
+        out[w] = Invert ? ~r : r;
+    }
+}
+
+// Evaluate a run of gates of one function; single inputs pass through AND with themselves and wider
+// gates fold their inputs pairwise, inverting only the last step
+template <int Operation, bool Invert>
+static void evaluateGates(const LogicSimulator::SimGate* begin, const LogicSimulator::SimGate* end, const uint32_t* gateInputs,
+                          uint64_t* values, size_t words) {
+    for (const LogicSimulator::SimGate* gate = begin; gate != end; ++gate) {
+        uint64_t* out = values + gate->output * words;
+        const uint32_t* inputs = gateInputs + gate->firstInput;
+        if (gate->numInputs == 2) {
+            wordKernel<Operation, Invert>(out, values + inputs[0] * words, values + inputs[1] * words, words);
+        } else if (gate->numInputs == 1) {
+            const uint64_t* input = values + inputs[0] * words;
+            wordKernel<WORD_AND, Invert>(out, input, input, words);
+        } else if (gate->numInputs == 0) {
+            std::fill(out, out + words, 0);
+        } else {
+            wordKernel<Operation, false>(out, values + inputs[0] * words, values + inputs[1] * words, words);
+            for (uint32_t k = 2; k + 1 < gate->numInputs; ++k) {
+                wordKernel<Operation, false>(out, out, values + inputs[k] * words, words);
+            }
+            wordKernel<Operation, Invert>(out, out, values + inputs[gate->numInputs - 1] * words, words);
+        }
+    }
+}
+
+LogicSimulator::LogicSimulator(const Netlist& netlist) {
+    build(netlist, std::vector<GateFunction>());
+}
+
+LogicSimulator::LogicSimulator(const Netlist& netlist, const std::vector<GateFunction>& functions) {
+    build(netlist, functions);
+}
+
+void LogicSimulator::build(const Netlist& netlist, const std::vector<GateFunction>& functions) {
+    std::unordered_map<std::string, uint32_t> netIndex;
+    netIndex["1'b0"] = 0;
+    netIndex["1'b1"] = 1;
+    netCount = 2;
+    undrivenCount = 0;
+    blockWords = 0;
+    for (const auto& input : netlist.inputs) {
+        netIndex[input] = static_cast<uint32_t>(netCount);
+        inputNets.push_back(static_cast<uint32_t>(netCount++));
+    }
+    // Gates are evaluated level by level and, within a level, grouped by function, so every group runs
+    // one kernel without data-dependent branches. Gate outputs are numbered in evaluation order.
+    NetlistGraph graph(netlist);
+    std::vector<GateFunction> gateFunctions(netlist.gates.size());
+    for (size_t index = 0; index < netlist.gates.size(); ++index) {
+        gateFunctions[index] = index < functions.size() ? functions[index] : gateFunction(netlist.gates[index].type);
+        if (gateFunctions[index] == GATE_UNKNOWN && errorMessage.empty()) {
+            errorMessage = "Unsupported gate type " + netlist.gates[index].type + " of gate " + netlist.gates[index].name;
+        }
+    }
+    std::vector<size_t> order = graph.order();
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (graph.level(a) != graph.level(b)) {
+            return graph.level(a) < graph.level(b);
+        }
+        return gateFunctions[a] < gateFunctions[b];
+    });
+    gateNets.resize(netlist.gates.size());
+    for (size_t index : order) {
+        netIndex[netlist.gates[index].output] = static_cast<uint32_t>(netCount);
+        gateNets[index] = static_cast<uint32_t>(netCount++);
+    }
+    auto lookup = [&](const std::string& name) {
+        auto it = netIndex.find(name);
+        if (it != netIndex.end()) {
+            return it->second;
+        }
+        undrivenCount++;
+        netIndex[name] = static_cast<uint32_t>(netCount);
+        return static_cast<uint32_t>(netCount++);
+    };
+    for (const auto& output : netlist.outputs) {
+        outputNets.push_back(lookup(output));
+    }
+
+    size_t groupLevel = 0;
+    for (size_t index : order) {
+        const Gate& gate = netlist.gates[index];
+        SimGate simGate;
+        simGate.function = gateFunctions[index];
+        if (groups.empty() || groups.back().function != simGate.function || graph.level(index) != groupLevel) {
+            GateGroup group;
+            group.function = simGate.function;
+            group.begin = static_cast<uint32_t>(gates.size());
+            groups.push_back(group);
+            groupLevel = graph.level(index);
+        }
+        groups.back().end = static_cast<uint32_t>(gates.size() + 1);
+        simGate.output = gateNets[index];
+        simGate.firstInput = static_cast<uint32_t>(gateInputs.size());
+        simGate.numInputs = static_cast<uint32_t>(gate.inputs.size());
+        for (const auto& input : gate.inputs) {
+            gateInputs.push_back(lookup(input));
+        }
+        gates.push_back(simGate);
+    }
+}
+
+const std::string& LogicSimulator::error() const {
+    return errorMessage;
+}
+
+size_t LogicSimulator::numInputs() const {
+    return inputNets.size();
+}
+
+size_t LogicSimulator::numOutputs() const {
+    return outputNets.size();
+}
+
+size_t LogicSimulator::numNets() const {
+    return netCount;
+}
+
+size_t LogicSimulator::undrivenNets() const {
+    return undrivenCount;
+}
+
+size_t LogicSimulator::inputNet(size_t input) const {
+    return inputNets[input];
+}
+
+size_t LogicSimulator::outputNet(size_t output) const {
+    return outputNets[output];
+}
+
+size_t LogicSimulator::gateNet(size_t gate) const {
+    return gateNets[gate];
+}
+
+const uint64_t* LogicSimulator::values(size_t net) const {
+    return netValues.data() + net * blockWords;
+}
+
+void LogicSimulator::randomInputs(Random& random, size_t words, std::vector<uint64_t>& inputs) const {
+    inputs.resize(inputNets.size() * words);
+    for (auto& word : inputs) {
+        word = random.next();
+    }
+}
+
+void LogicSimulator::simulate(const std::vector<uint64_t>& inputs, size_t words) {
+    if (words != blockWords) {
+        // Undriven nets are never written and keep their zeros
+        blockWords = words;
+        netValues.assign(netCount * words, 0);
+        std::fill(netValues.begin() + words, netValues.begin() + 2 * words, ~0ULL);
+    }
+    for (size_t i = 0; i < inputNets.size(); ++i) {
+        std::memcpy(netValues.data() + inputNets[i] * words, inputs.data() + i * words, words * sizeof(uint64_t));
+    }
+    for (const auto& group : groups) {
+        const SimGate* begin = gates.data() + group.begin;
+        const SimGate* end = gates.data() + group.end;
+        uint64_t* values = netValues.data();
+        switch (group.function) {
+        case GATE_AND: evaluateGates<WORD_AND, false>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_NAND: evaluateGates<WORD_AND, true>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_OR: evaluateGates<WORD_OR, false>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_NOR: evaluateGates<WORD_OR, true>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_XOR: evaluateGates<WORD_XOR, false>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_XNOR: evaluateGates<WORD_XOR, true>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_NOT: evaluateGates<WORD_AND, true>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_BUF: evaluateGates<WORD_AND, false>(begin, end, gateInputs.data(), values, words); break;
+        case GATE_UNKNOWN:
+            for (const SimGate* gate = begin; gate != end; ++gate) {
+                std::fill(values + gate->output * words, values + (gate->output + 1) * words, 0);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef LOGIC_SIMULATOR_HPP
+#define LOGIC_SIMULATOR_HPP
+
+#include "NetlistParser.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum GateFunction {
+    GATE_AND,
+    GATE_NAND,
+    GATE_OR,
+    GATE_NOR,
+    GATE_XOR,
+    GATE_XNOR,
+    GATE_NOT,
+    GATE_BUF,
+    GATE_UNKNOWN
+};
+
+// Logic function of a gate type name (and, nand, or, nor, xor, xnor, not, buf)
+GateFunction gateFunction(const std::string& type);
+
+// Bit-parallel simulator of a combinational netlist. Every net holds a block of 64-bit words, one bit
+// per input pattern, and the gates are evaluated once per block in topological order, so a block of
+// W words simulates 64 W patterns in one pass. The per-gate kernels are plain word loops; when built
+// with AVX2 (e.g. -mavx2) they process four words per instruction.
+//
+// Nets 0 and 1 are the constants 1'b0 and 1'b1, followed by the primary inputs in declaration order and
+// then the gate outputs. Nets that nothing drives read as 0.
+class LogicSimulator {
+public:
+    // Gate functions are taken from the gate types
+    explicit LogicSimulator(const Netlist& netlist);
+    // Gate functions given per gate, e.g. for a mapped netlist whose gate types are cell names
+    LogicSimulator(const Netlist& netlist, const std::vector<GateFunction>& functions);
+
+    // Empty unless a gate type is not one of the supported functions
+    const std::string& error() const;
+
+    size_t numInputs() const;
+    size_t numOutputs() const;
+    size_t numNets() const;
+    size_t undrivenNets() const;
+    size_t inputNet(size_t input) const;
+    size_t outputNet(size_t output) const;
+    size_t gateNet(size_t gate) const;  // Net driven by the gate, in netlist order
+
+    // Simulate 64 * words patterns; inputs holds words values per primary input, input after input
+    void simulate(const std::vector<uint64_t>& inputs, size_t words);
+    // Values of a net from the last simulation, words values
+    const uint64_t* values(size_t net) const;
+
+    // Uniformly random input patterns for simulate
+    void randomInputs(Random& random, size_t words, std::vector<uint64_t>& inputs) const;
+
+    struct SimGate {
+        GateFunction function;
+        uint32_t output;
+        uint32_t firstInput;  // Into gateInputs
+        uint32_t numInputs;
+    };
+
+private:
+    // Consecutive gates of one level and function
+    struct GateGroup {
+        GateFunction function;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    std::vector<SimGate> gates;  // By level, then function
+    std::vector<GateGroup> groups;
+    std::vector<uint32_t> gateInputs;
+    std::vector<uint32_t> inputNets;
+    std::vector<uint32_t> outputNets;
+    std::vector<uint32_t> gateNets;
+    size_t netCount;
+    size_t undrivenCount;
+    std::string errorMessage;
+    size_t blockWords;
+    std::vector<uint64_t> netValues;
+
+    void build(const Netlist& netlist, const std::vector<GateFunction>& functions);
+};
+
+#endif // LOGIC_SIMULATOR_HPP
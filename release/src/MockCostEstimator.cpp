@@ -0,0 +1,201 @@
+#include "MockCostEstimator.hpp"
+#include "SwitchingActivity.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+bool MockCostConfig::set(const std::string& key, const std::string& value) {
+    try {
+        if (key == "weights") {
+            weights.clear();
+            std::string list = value;
+            std::replace(list.begin(), list.end(), ':', ',');
+            std::istringstream iss(list);
+            std::string weight;
+            while (std::getline(iss, weight, ',')) {
+                weights.push_back(std::stof(weight));
+            }
+        } else if (key == "delay_weight") {
+            delayWeight = std::stof(value);
+        } else if (key == "delay_attr") {
+            delayAttribute = std::stoul(value);
+        } else if (key == "power_weight") {
+            powerWeight = std::stof(value);
+        } else if (key == "power_attr") {
+            powerAttribute = std::stoul(value);
+        } else if (key == "latency") {
+            latencyMs = std::stoi(value);
+        } else {
+            std::cerr << "Error: Unknown mock estimator option " << key << std::endl;
+            return false;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid value for mock estimator option " << key << ": " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MockCostConfig::parseSpec(const std::string& spec) {
+    std::istringstream iss(spec);
+    std::string option;
+    while (std::getline(iss, option, ',')) {
+        if (option.empty()) {
+            continue;
+        }
+        size_t pos = option.find('=');
+        if (pos == std::string::npos || !set(option.substr(0, pos), option.substr(pos + 1))) {
+            std::cerr << "Error: Invalid mock estimator option " << option << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+MockCostEstimator::MockCostEstimator(const std::vector<Cell>& cells, const MockCostConfig& config) : config(config) {
+    for (const auto& cell : cells) {
+        cellsByName[cell.cell_name] = cell;
+    }
+}
+
+const MockCostConfig& MockCostEstimator::configuration() const {
+    return config;
+}
+
+float MockCostEstimator::estimate(const Netlist& mappedNetlist) const {
+    std::vector<const Cell*> gateCells(mappedNetlist.gates.size(), nullptr);
+    for (size_t i = 0; i < mappedNetlist.gates.size(); ++i) {
+        auto it = cellsByName.find(mappedNetlist.gates[i].type);
+        if (it != cellsByName.end()) {
+            gateCells[i] = &it->second;
+        } else {
+            std::cerr << "Warning: Unknown cell " << mappedNetlist.gates[i].type << " for gate " << mappedNetlist.gates[i].name << std::endl;
+        }
+    }
+    return estimate(mappedNetlist, gateCells);
+}
+
+float MockCostEstimator::estimate(const Netlist& netlist, const std::unordered_map<std::string, std::string>& gateToCellMapping) const {
+    std::vector<const Cell*> gateCells(netlist.gates.size(), nullptr);
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        auto mapped = gateToCellMapping.find(netlist.gates[i].name);
+        if (mapped == gateToCellMapping.end()) {
+            continue;
+        }
+        auto it = cellsByName.find(mapped->second);
+        if (it != cellsByName.end()) {
+            gateCells[i] = &it->second;
+        }
+    }
+    return estimate(netlist, gateCells);
+}
+
+float MockCostEstimator::estimate(const Netlist& netlist, const std::vector<const Cell*>& gateCells) const {
+    if (config.latencyMs > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.latencyMs));
+    }
+
+    // Additive part: weighted attributes of every used cell
+    double cost = 0.0;
+    for (const Cell* cell : gateCells) {
+        if (cell == nullptr) {
+            continue;
+        }
+        for (size_t k = 0; k < cell->float_data.size(); ++k) {
+            float weight = k < config.weights.size() ? config.weights[k] : 1.0f;
+            cost += weight * cell->float_data[k];
+        }
+    }
+
+    // Longest path part: arrival times propagated in topological order
+    std::shared_ptr<const NetlistStructure> shared = netlistStructure(netlist, gateCells);
+    std::vector<double> arrival(netlist.gates.size(), 0.0);
+    double longestPath = 0.0;
+    for (size_t gate : shared->order) {
+        for (size_t fanin : shared->fanins[gate]) {
+            arrival[gate] = std::max(arrival[gate], arrival[fanin]);
+        }
+        const Cell* cell = gateCells[gate];
+        if (cell != nullptr && config.delayAttribute < cell->float_data.size()) {
+            arrival[gate] += cell->float_data[config.delayAttribute];
+        }
+        longestPath = std::max(longestPath, arrival[gate]);
+    }
+
+    // Switching power part: per-cell energies weighted by the cached toggle rates
+    if (config.powerWeight != 0.0f) {
+        double power = 0.0;
+        for (size_t i = 0; i < netlist.gates.size(); ++i) {
+            const Cell* cell = gateCells[i];
+            if (cell != nullptr && config.powerAttribute < cell->float_data.size()) {
+                power += shared->toggleRates[i] * cell->float_data[config.powerAttribute];
+            }
+        }
+        cost += config.powerWeight * power;
+    }
+
+    return static_cast<float>(cost + config.delayWeight * longestPath);
+}
+
+std::shared_ptr<const MockCostEstimator::NetlistStructure> MockCostEstimator::netlistStructure(const Netlist& netlist,
+                                                                                                const std::vector<const Cell*>& gateCells) const {
+    std::lock_guard<std::mutex> lock(structureMutex);
+    bool needRates = config.powerWeight != 0.0f;
+    if (structure && structure->netlist == &netlist && structure->fanins.size() == netlist.gates.size() &&
+        (!needRates || !structure->toggleRates.empty() || netlist.gates.empty())) {
+        return structure;
+    }
+    std::shared_ptr<NetlistStructure> built = std::make_shared<NetlistStructure>();
+    built->netlist = &netlist;
+    built->fanins.resize(netlist.gates.size());
+    std::unordered_map<std::string, size_t> driver;
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        driver[netlist.gates[i].output] = i;
+    }
+    std::vector<std::vector<size_t>> fanouts(netlist.gates.size());
+    std::vector<size_t> pendingInputs(netlist.gates.size(), 0);
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        for (const auto& input : netlist.gates[i].inputs) {
+            auto it = driver.find(input);
+            if (it != driver.end()) {
+                built->fanins[i].push_back(it->second);
+                fanouts[it->second].push_back(i);
+                pendingInputs[i]++;
+            }
+        }
+    }
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        if (pendingInputs[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    while (!ready.empty()) {
+        size_t gate = ready.back();
+        ready.pop_back();
+        built->order.push_back(gate);
+        for (size_t fanout : fanouts[gate]) {
+            if (--pendingInputs[fanout] == 0) {
+                ready.push_back(fanout);
+            }
+        }
+    }
+
+    if (needRates) {
+        // The cells of a gate all implement its gate type, so any mapping yields the same functions
+        std::vector<GateFunction> functions(netlist.gates.size());
+        for (size_t i = 0; i < netlist.gates.size(); ++i) {
+            functions[i] = gateFunction(gateCells[i] != nullptr ? gateCells[i]->cell_type : netlist.gates[i].type);
+        }
+        SwitchingActivity activity(netlist, functions);
+        activity.propagate(0.5);
+        built->toggleRates.resize(netlist.gates.size());
+        for (size_t i = 0; i < netlist.gates.size(); ++i) {
+            built->toggleRates[i] = activity.toggleRate(i);
+        }
+    }
+    structure = built;
+    return structure;
+}
@@ -0,0 +1,63 @@
+#ifndef MOCK_COST_ESTIMATOR_HPP
+#define MOCK_COST_ESTIMATOR_HPP
+
+#include "CellLibraryParser.hpp"
+#include "NetlistParser.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct MockCostConfig {
+    std::vector<float> weights;   // Weight per float attribute of a cell, missing entries count as 1
+    float delayWeight = 1.0f;     // Weight of the longest path term
+    size_t delayAttribute = 1;    // Float attribute used as the cell delay
+    float powerWeight = 0.0f;     // Weight of the activity-weighted switching power term
+    size_t powerAttribute = 3;    // Float attribute used as the switching energy of a cell
+    int latencyMs = 0;            // Artificial estimator runtime
+
+    // Set one option by name (weights, delay_weight, delay_attr, power_weight, power_attr, latency);
+    // weights are comma separated
+    bool set(const std::string& key, const std::string& value);
+    // Parse a comma separated list of key=value options, weights separated by ':'
+    bool parseSpec(const std::string& spec);
+};
+
+// Deterministic stand-in for the contest cost estimators. The cost is a weighted sum of the
+// attributes of every used cell plus a weighted longest-path delay, so it has both an additive
+// and a non-local part. Optionally it adds switching power: the energy attribute of every cell
+// times the toggle rate of its output, from the analytical switching activity estimate. The gate
+// connections and the toggle rates do not depend on the chosen cells, so they are derived once per
+// netlist and every estimate only walks the cached order and sums the cell attributes.
+class MockCostEstimator {
+public:
+    MockCostEstimator(const std::vector<Cell>& cells, const MockCostConfig& config);
+
+    const MockCostConfig& configuration() const;
+
+    // Cost of a mapped netlist whose gate types are cell names
+    float estimate(const Netlist& mappedNetlist) const;
+    // Cost of a netlist with a separate gate-to-cell mapping
+    float estimate(const Netlist& netlist, const std::unordered_map<std::string, std::string>& gateToCellMapping) const;
+    // Cost of a netlist whose gate i uses gateCells[i] (nullptr for unmapped gates)
+    float estimate(const Netlist& netlist, const std::vector<const Cell*>& gateCells) const;
+
+private:
+    MockCostConfig config;
+    std::unordered_map<std::string, Cell> cellsByName;
+
+    // Gate connections of the last netlist estimated; pool workers share them
+    struct NetlistStructure {
+        const Netlist* netlist = nullptr;
+        std::vector<std::vector<size_t>> fanins;  // Gates driving each gate, once per input pin
+        std::vector<size_t> order;                // Topological order; gates on cycles are left out
+        std::vector<double> toggleRates;          // Empty until an estimate with a power term needs them
+    };
+    mutable std::mutex structureMutex;
+    mutable std::shared_ptr<const NetlistStructure> structure;
+
+    std::shared_ptr<const NetlistStructure> netlistStructure(const Netlist& netlist, const std::vector<const Cell*>& gateCells) const;
+};
+
+#endif // MOCK_COST_ESTIMATOR_HPP
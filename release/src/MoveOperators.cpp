@@ -0,0 +1,205 @@
+#include "MoveOperators.hpp"
+#include <algorithm>
+
+static const size_t kConeDepth = 2;         // Fanout levels resized together with the root gate
+static const size_t kPathWindow = 4;        // Critical path gates resized together
+
+static void addMove(const CellAssignment& assignment, size_t gate, uint16_t cell, std::vector<CellMove>& moves) {
+    if (assignment[gate] == cell || assignment[gate] == kNoCell) {
+        return;
+    }
+    CellMove move;
+    move.gate = static_cast<uint32_t>(gate);
+    move.oldCell = assignment[gate];
+    move.newCell = cell;
+    moves.push_back(move);
+}
+
+MoveOperator::MoveOperator(const CellTable& cellTable, const NetlistGraph& graph)
+    : cellTable(cellTable), graph(graph), sizeOrder(cellTable.numTypes()), sizeRank(cellTable.numCells(), 0) {
+    for (size_t i = 0; i < cellTable.numGates(); ++i) {
+        if (cellTable.candidates(i).size() > 1) {
+            movableGates.push_back(i);
+        }
+    }
+    for (size_t t = 0; t < cellTable.numTypes(); ++t) {
+        sizeOrder[t] = cellTable.typeCells(t);
+        std::stable_sort(sizeOrder[t].begin(), sizeOrder[t].end(), [&](uint16_t a, uint16_t b) {
+            const std::vector<float>& x = cellTable.cell(a).float_data;
+            const std::vector<float>& y = cellTable.cell(b).float_data;
+            return !x.empty() && !y.empty() && x[0] < y[0];
+        });
+        for (size_t r = 0; r < sizeOrder[t].size(); ++r) {
+            sizeRank[sizeOrder[t][r]] = r;
+        }
+    }
+}
+
+MoveOperator::~MoveOperator() {}
+
+size_t MoveOperator::randomMovableGate(Random& random) const {
+    return movableGates[random.below(movableGates.size())];
+}
+
+bool MoveOperator::resize(const CellAssignment& assignment, size_t gate, int direction, std::vector<CellMove>& moves) const {
+    uint16_t cell = assignment[gate];
+    const std::vector<uint16_t>& order = sizeOrder[cellTable.typeOf(gate)];
+    if (cell == kNoCell || order.size() < 2) {
+        return false;
+    }
+    size_t rank = sizeRank[cell];
+    if ((direction > 0 && rank + 1 >= order.size()) || (direction < 0 && rank == 0)) {
+        return false;
+    }
+    addMove(assignment, gate, order[direction > 0 ? rank + 1 : rank - 1], moves);
+    return true;
+}
+
+const char* SingleSwapOperator::name() const {
+    return "single";
+}
+
+bool SingleSwapOperator::propose(const CellAssignment& assignment, const CellAssignment&, Random& random, std::vector<CellMove>& moves) {
+    if (movableGates.empty()) {
+        return false;
+    }
+    size_t gate = randomMovableGate(random);
+    const std::vector<uint16_t>& cells = cellTable.candidates(gate);
+    uint16_t cell = cells[random.below(cells.size() - 1)];
+    if (cell == assignment[gate]) {
+        cell = cells.back();
+    }
+    addMove(assignment, gate, cell, moves);
+    return !moves.empty();
+}
+
+TypeWideOperator::TypeWideOperator(const CellTable& cellTable, const NetlistGraph& graph)
+    : MoveOperator(cellTable, graph), typeGates(cellTable.numTypes()) {
+    for (size_t i = 0; i < cellTable.numGates(); ++i) {
+        typeGates[cellTable.typeOf(i)].push_back(i);
+    }
+    for (size_t t = 1; t < cellTable.numTypes(); ++t) {
+        if (cellTable.typeCells(t).size() > 1 && !typeGates[t].empty()) {
+            types.push_back(t);
+        }
+    }
+}
+
+const char* TypeWideOperator::name() const {
+    return "type-wide";
+}
+
+bool TypeWideOperator::propose(const CellAssignment& assignment, const CellAssignment&, Random& random, std::vector<CellMove>& moves) {
+    if (types.empty()) {
+        return false;
+    }
+    size_t type = types[random.below(types.size())];
+    const std::vector<uint16_t>& cells = cellTable.typeCells(type);
+    uint16_t cell = cells[random.below(cells.size())];
+    for (size_t gate : typeGates[type]) {
+        addMove(assignment, gate, cell, moves);
+    }
+    return !moves.empty();
+}
+
+const char* FanoutConeResizeOperator::name() const {
+    return "fanout-cone";
+}
+
+bool FanoutConeResizeOperator::propose(const CellAssignment& assignment, const CellAssignment&, Random& random, std::vector<CellMove>& moves) {
+    if (movableGates.empty()) {
+        return false;
+    }
+    int direction = random.below(2) == 0 ? -1 : 1;
+    for (size_t gate : graph.fanoutCone(randomMovableGate(random), kConeDepth)) {
+        resize(assignment, gate, direction, moves);
+    }
+    return !moves.empty();
+}
+
+CriticalPathResizeOperator::CriticalPathResizeOperator(const CellTable& cellTable, const NetlistGraph& graph, int delayAttribute)
+    : MoveOperator(cellTable, graph), delayAttribute(delayAttribute) {}
+
+const char* CriticalPathResizeOperator::name() const {
+    return "critical-path";
+}
+
+std::vector<size_t> CriticalPathResizeOperator::criticalPath(const CellAssignment& assignment) const {
+    std::vector<double> arrival(graph.numGates(), 0.0);
+    std::vector<size_t> previous(graph.numGates(), graph.numGates());
+    size_t end = graph.numGates();
+    double longest = -1.0;
+    for (size_t gate : graph.order()) {
+        double start = 0.0;
+        for (size_t fanin : graph.fanins(gate)) {
+            if (previous[gate] == graph.numGates() || arrival[fanin] > start) {
+                start = arrival[fanin];
+                previous[gate] = fanin;
+            }
+        }
+        double delay = 1.0;
+        if (delayAttribute >= 0) {
+            delay = 0.0;
+            if (assignment[gate] != kNoCell) {
+                const std::vector<float>& data = cellTable.cell(assignment[gate]).float_data;
+                delay = static_cast<size_t>(delayAttribute) < data.size() ? data[delayAttribute] : 0.0;
+            }
+        }
+        arrival[gate] = start + delay;
+        if (arrival[gate] > longest) {
+            longest = arrival[gate];
+            end = gate;
+        }
+    }
+    std::vector<size_t> path;
+    for (size_t gate = end; gate < graph.numGates(); gate = previous[gate]) {
+        path.push_back(gate);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool CriticalPathResizeOperator::propose(const CellAssignment& assignment, const CellAssignment&, Random& random, std::vector<CellMove>& moves) {
+    std::vector<size_t> path = criticalPath(assignment);
+    if (path.empty()) {
+        return false;
+    }
+    size_t first = random.below(path.size());
+    int direction = random.below(2) == 0 ? -1 : 1;
+    for (size_t i = first; i < path.size() && i < first + kPathWindow; ++i) {
+        resize(assignment, path[i], direction, moves);
+    }
+    return !moves.empty();
+}
+
+const char* RevertToBestOperator::name() const {
+    return "revert-to-best";
+}
+
+bool RevertToBestOperator::propose(const CellAssignment& assignment, const CellAssignment& best, Random& random, std::vector<CellMove>& moves) {
+    if (best.size() != assignment.size()) {
+        return false;
+    }
+    std::vector<size_t> differing;
+    for (size_t gate = 0; gate < assignment.size(); ++gate) {
+        if (assignment[gate] != best[gate] && best[gate] != kNoCell) {
+            differing.push_back(gate);
+        }
+    }
+    if (differing.empty()) {
+        return false;
+    }
+    size_t gate = differing[random.below(differing.size())];
+    addMove(assignment, gate, best[gate], moves);
+    return !moves.empty();
+}
+
+std::vector<std::unique_ptr<MoveOperator>> createMoveOperators(const CellTable& cellTable, const NetlistGraph& graph, int delayAttribute) {
+    std::vector<std::unique_ptr<MoveOperator>> operators;
+    operators.push_back(std::unique_ptr<MoveOperator>(new SingleSwapOperator(cellTable, graph)));
+    operators.push_back(std::unique_ptr<MoveOperator>(new TypeWideOperator(cellTable, graph)));
+    operators.push_back(std::unique_ptr<MoveOperator>(new FanoutConeResizeOperator(cellTable, graph)));
+    operators.push_back(std::unique_ptr<MoveOperator>(new CriticalPathResizeOperator(cellTable, graph, delayAttribute)));
+    operators.push_back(std::unique_ptr<MoveOperator>(new RevertToBestOperator(cellTable, graph)));
+    return operators;
+}
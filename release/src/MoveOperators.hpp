@@ -0,0 +1,89 @@
+#ifndef MOVE_OPERATORS_HPP
+#define MOVE_OPERATORS_HPP
+
+#include "CellAssignment.hpp"
+#include "NetlistGraph.hpp"
+#include "Random.hpp"
+#include <memory>
+#include <vector>
+
+// A way of proposing a neighbor: a set of moves on distinct gates away from the given assignment.
+// Operators that resize gates step through the cells of a type ordered by their first attribute.
+class MoveOperator {
+public:
+    MoveOperator(const CellTable& cellTable, const NetlistGraph& graph);
+    virtual ~MoveOperator();
+
+    virtual const char* name() const = 0;
+    // Append the proposed moves; returns false when the operator has nothing to propose
+    virtual bool propose(const CellAssignment& assignment, const CellAssignment& best, Random& random,
+                         std::vector<CellMove>& moves) = 0;
+
+protected:
+    const CellTable& cellTable;
+    const NetlistGraph& graph;
+    std::vector<size_t> movableGates;
+
+    size_t randomMovableGate(Random& random) const;
+    // Move the gate one step up (direction > 0) or down its type's size order, if there is a next cell
+    bool resize(const CellAssignment& assignment, size_t gate, int direction, std::vector<CellMove>& moves) const;
+
+private:
+    std::vector<std::vector<uint16_t>> sizeOrder;  // Per type, cells by ascending first attribute
+    std::vector<size_t> sizeRank;                  // Per cell, position in its type's size order
+};
+
+// The annealer's move: one random gate to a random different cell
+class SingleSwapOperator : public MoveOperator {
+public:
+    using MoveOperator::MoveOperator;
+    const char* name() const override;
+    bool propose(const CellAssignment& assignment, const CellAssignment& best, Random& random, std::vector<CellMove>& moves) override;
+};
+
+// Every gate of a random type to the same random cell
+class TypeWideOperator : public MoveOperator {
+public:
+    TypeWideOperator(const CellTable& cellTable, const NetlistGraph& graph);
+    const char* name() const override;
+    bool propose(const CellAssignment& assignment, const CellAssignment& best, Random& random, std::vector<CellMove>& moves) override;
+
+private:
+    std::vector<size_t> types;
+    std::vector<std::vector<size_t>> typeGates;
+};
+
+// A gate and its fanout cone, a few levels deep, resized in the same direction
+class FanoutConeResizeOperator : public MoveOperator {
+public:
+    using MoveOperator::MoveOperator;
+    const char* name() const override;
+    bool propose(const CellAssignment& assignment, const CellAssignment& best, Random& random, std::vector<CellMove>& moves) override;
+};
+
+// A few consecutive gates of the longest path resized in the same direction. Cell delays are taken
+// from the given float attribute; with a negative attribute every gate counts as one unit of delay.
+class CriticalPathResizeOperator : public MoveOperator {
+public:
+    CriticalPathResizeOperator(const CellTable& cellTable, const NetlistGraph& graph, int delayAttribute);
+    const char* name() const override;
+    bool propose(const CellAssignment& assignment, const CellAssignment& best, Random& random, std::vector<CellMove>& moves) override;
+
+private:
+    int delayAttribute;
+
+    std::vector<size_t> criticalPath(const CellAssignment& assignment) const;
+};
+
+// One gate whose cell differs from the best assignment back to its best cell
+class RevertToBestOperator : public MoveOperator {
+public:
+    using MoveOperator::MoveOperator;
+    const char* name() const override;
+    bool propose(const CellAssignment& assignment, const CellAssignment& best, Random& random, std::vector<CellMove>& moves) override;
+};
+
+// All operators above, in that order
+std::vector<std::unique_ptr<MoveOperator>> createMoveOperators(const CellTable& cellTable, const NetlistGraph& graph, int delayAttribute);
+
+#endif // MOVE_OPERATORS_HPP
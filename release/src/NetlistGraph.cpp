@@ -0,0 +1,102 @@
+#include "NetlistGraph.hpp"
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
+NetlistGraph::NetlistGraph(const Netlist& netlist)
+    : faninGates(netlist.gates.size()), fanoutGates(netlist.gates.size()), levels(netlist.gates.size(), 0), numLevels(0) {
+    std::unordered_map<std::string, size_t> driver;
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        driver[netlist.gates[i].output] = i;
+    }
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        for (const auto& input : netlist.gates[i].inputs) {
+            auto it = driver.find(input);
+            if (it != driver.end()) {
+                faninGates[i].push_back(it->second);
+                fanoutGates[it->second].push_back(i);
+            }
+        }
+    }
+
+    // Kahn's algorithm; a gate's level is one more than its deepest fanin
+    std::vector<size_t> pending(netlist.gates.size());
+    std::deque<size_t> ready;
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        pending[i] = faninGates[i].size();
+        if (pending[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    std::vector<bool> placed(netlist.gates.size(), false);
+    while (!ready.empty()) {
+        size_t gate = ready.front();
+        ready.pop_front();
+        placed[gate] = true;
+        topologicalOrder.push_back(gate);
+        numLevels = std::max(numLevels, levels[gate] + 1);
+        for (size_t fanout : fanoutGates[gate]) {
+            levels[fanout] = std::max(levels[fanout], levels[gate] + 1);
+            if (--pending[fanout] == 0) {
+                ready.push_back(fanout);
+            }
+        }
+    }
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        if (!placed[i]) {
+            topologicalOrder.push_back(i);
+        }
+    }
+}
+
+size_t NetlistGraph::numGates() const {
+    return faninGates.size();
+}
+
+const std::vector<size_t>& NetlistGraph::fanins(size_t gate) const {
+    return faninGates[gate];
+}
+
+const std::vector<size_t>& NetlistGraph::fanouts(size_t gate) const {
+    return fanoutGates[gate];
+}
+
+const std::vector<size_t>& NetlistGraph::order() const {
+    return topologicalOrder;
+}
+
+size_t NetlistGraph::level(size_t gate) const {
+    return levels[gate];
+}
+
+size_t NetlistGraph::depth() const {
+    return numLevels;
+}
+
+std::vector<size_t> NetlistGraph::faninCone(size_t root, size_t maxDepth) const {
+    return cone(root, maxDepth, faninGates);
+}
+
+std::vector<size_t> NetlistGraph::fanoutCone(size_t root, size_t maxDepth) const {
+    return cone(root, maxDepth, fanoutGates);
+}
+
+std::vector<size_t> NetlistGraph::cone(size_t root, size_t maxDepth, const std::vector<std::vector<size_t>>& edges) const {
+    // Breadth-first, so the depth limit counts the shortest distance from the root
+    std::vector<size_t> gates(1, root);
+    std::unordered_map<size_t, size_t> distance;
+    distance[root] = 0;
+    for (size_t next = 0; next < gates.size(); ++next) {
+        size_t gate = gates[next];
+        if (maxDepth > 0 && distance[gate] >= maxDepth) {
+            continue;
+        }
+        for (size_t neighbor : edges[gate]) {
+            if (distance.find(neighbor) == distance.end()) {
+                distance[neighbor] = distance[gate] + 1;
+                gates.push_back(neighbor);
+            }
+        }
+    }
+    return gates;
+}
@@ -0,0 +1,38 @@
+#ifndef NETLIST_GRAPH_HPP
+#define NETLIST_GRAPH_HPP
+
+#include "NetlistParser.hpp"
+#include <cstddef>
+#include <vector>
+
+// Gate-level connectivity of a netlist: for every gate the gates driving its inputs and the gates its
+// output drives, a topological order and logic levels. Primary inputs have no driver gate and level 0
+// gates read only primary inputs.
+class NetlistGraph {
+public:
+    explicit NetlistGraph(const Netlist& netlist);
+
+    size_t numGates() const;
+    const std::vector<size_t>& fanins(size_t gate) const;
+    const std::vector<size_t>& fanouts(size_t gate) const;
+    // Gates in topological order; gates on combinational loops, if any, are appended at the end
+    const std::vector<size_t>& order() const;
+    size_t level(size_t gate) const;
+    size_t depth() const;  // Number of levels
+
+    // The gate and its transitive fanin gates up to maxDepth levels back (0 means unlimited)
+    std::vector<size_t> faninCone(size_t root, size_t maxDepth) const;
+    // The gate and its transitive fanout gates up to maxDepth levels ahead (0 means unlimited)
+    std::vector<size_t> fanoutCone(size_t root, size_t maxDepth) const;
+
+private:
+    std::vector<std::vector<size_t>> faninGates;
+    std::vector<std::vector<size_t>> fanoutGates;
+    std::vector<size_t> topologicalOrder;
+    std::vector<size_t> levels;
+    size_t numLevels;
+
+    std::vector<size_t> cone(size_t root, size_t maxDepth, const std::vector<std::vector<size_t>>& edges) const;
+};
+
+#endif // NETLIST_GRAPH_HPP
@@ -19,25 +19,33 @@ std::string trim(const std::string &s) {
     return std::string(start, end + 1);
 }
 
-NetlistParser::NetlistParser(const std::string& filepath) : filepath(filepath) {}
+NetlistParser::NetlistParser(const std::string& filepath, bool outputFirst) : filepath(filepath), outputFirst(outputFirst) {}
 
 const Netlist& NetlistParser::getNetlist() const {
     return netlist;
 }
 
 void NetlistParser::parse(const std::string& outputFilename) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "Could not open the file: " << filepath << std::endl;
-        exit(1);
-    }
-
     std::ofstream outFile(outputFilename);
     if (!outFile.is_open()) {
         std::cerr << "Could not open the output file: " << outputFilename << std::endl;
         exit(1);
     }
 
+    parse();
+
+    // Write the parsed netlist to the output file
+    printNetlist(outFile, netlist);
+    outFile.close();
+}
+
+void NetlistParser::parse() {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Could not open the file: " << filepath << std::endl;
+        exit(1);
+    }
+
     std::string line;
     std::string collectedLine;
     bool collecting = false;
@@ -54,7 +62,8 @@ void NetlistParser::parse(const std::string& outputFilename) {
 
         if (line.find("module") != std::string::npos && line.find("//") == std::string::npos) {
             collectedLine = line;
-            while (std::getline(file, line)) {
+            // The port list may start on a later line
+            while (collectedLine.find('(') == std::string::npos && std::getline(file, line)) {
                 line = trim(line);
                 if (line.empty() || line[0] == '/') {
                     continue; // Skip empty lines and comments
@@ -120,10 +129,6 @@ void NetlistParser::parse(const std::string& outputFilename) {
     }
 
     file.close();
-
-    // Write the parsed netlist to the output file
-    printNetlist(outFile, netlist);
-    outFile.close();
 }
 
 void NetlistParser::parseModule(const std::string& line) {
@@ -195,7 +200,11 @@ void NetlistParser::parseGate(const std::string& line) {
     gate.name = gateName;
 
     // Swap format to (input1, input2, output) or (input, output)
-    if (connectionsList.size() > 1) {
+    if (connectionsList.size() > 1 && !outputFirst) {
+        gate.output = connectionsList.back();
+        connectionsList.pop_back();
+        gate.inputs = connectionsList;
+    } else if (connectionsList.size() > 1) {
         gate.output = connectionsList[0];
         connectionsList.erase(connectionsList.begin());
         gate.inputs = connectionsList;
@@ -22,13 +22,16 @@ struct Netlist {
 
 class NetlistParser {
 public:
-    NetlistParser(const std::string& filepath);
+    // Gate connections are listed output first in the input designs and output last in mapped netlists
+    NetlistParser(const std::string& filepath, bool outputFirst = true);
+    void parse();
     void parse(const std::string& outputFilename);
     const Netlist& getNetlist() const;
     void printNetlist(std::ofstream& outFile, const Netlist& netlist);
 
 private:
     std::string filepath;
+    bool outputFirst;
     Netlist netlist;
 
     void parseModule(const std::string& line);
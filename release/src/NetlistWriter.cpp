@@ -5,6 +5,20 @@
 #include <unordered_set>
 
 void NetlistWriter::writeNetlist(const Netlist& netlist, const std::unordered_map<std::string, std::string>& gateToCellMapping, const std::string& outputFilename) {
+    writeNetlist(netlist, [&](size_t gate) -> const std::string* {
+        auto it = gateToCellMapping.find(netlist.gates[gate].name);
+        return it != gateToCellMapping.end() ? &it->second : nullptr;
+    }, outputFilename);
+}
+
+void NetlistWriter::writeNetlist(const Netlist& netlist, const std::vector<std::string>& cellNames, const std::vector<uint16_t>& gateCells,
+                                 const std::string& outputFilename) {
+    writeNetlist(netlist, [&](size_t gate) -> const std::string* {
+        return gate < gateCells.size() && gateCells[gate] < cellNames.size() ? &cellNames[gateCells[gate]] : nullptr;
+    }, outputFilename);
+}
+
+void NetlistWriter::writeNetlist(const Netlist& netlist, const std::function<const std::string*(size_t)>& cellOfGate, const std::string& outputFilename) {
     std::ofstream outFile(outputFilename);
     if (!outFile.is_open()) {
         std::cerr << "Error opening output file: " << outputFilename << std::endl;
@@ -73,10 +87,11 @@ void NetlistWriter::writeNetlist(const Netlist& netlist, const std::unordered_ma
     }
 
     // Print gates and ensure the correct port order
-    for (const auto& gate : netlist.gates) {
-        auto it = gateToCellMapping.find(gate.name);
-        if (it != gateToCellMapping.end()) {
-            outFile << " " << it->second << " " << gate.name << " (";
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        const Gate& gate = netlist.gates[i];
+        const std::string* cell = cellOfGate(i);
+        if (cell != nullptr) {
+            outFile << " " << *cell << " " << gate.name << " (";
             if (gate.inputs.size() == 2) {
                 // For 2-input gates: (input1, input2, output)
                 outFile << gate.inputs[0] << ", " << gate.inputs[1] << ", " << gate.output;
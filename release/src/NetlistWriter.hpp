@@ -1,6 +1,8 @@
 #ifndef NETLIST_WRITER_HPP
 #define NETLIST_WRITER_HPP
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -9,6 +11,12 @@
 class NetlistWriter {
 public:
     void writeNetlist(const Netlist& netlist, const std::unordered_map<std::string, std::string>& gateToCellMapping, const std::string& outputFilename);
+    // Write a netlist whose gate i uses cellNames[gateCells[i]]
+    void writeNetlist(const Netlist& netlist, const std::vector<std::string>& cellNames, const std::vector<uint16_t>& gateCells,
+                      const std::string& outputFilename);
+
+private:
+    void writeNetlist(const Netlist& netlist, const std::function<const std::string*(size_t)>& cellOfGate, const std::string& outputFilename);
 };
 
 #endif // NETLIST_WRITER_HPP
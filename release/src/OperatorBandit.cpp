@@ -0,0 +1,85 @@
+#include "OperatorBandit.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const double kMinSeconds = 1e-3;     // Charge for moves resolved without the estimator
+static const double kVarianceFloor = 0.01;  // Minimum normalized reward variance for Thompson sampling
+
+OperatorBandit::OperatorBandit(size_t numArms, BanditPolicy policy)
+    : policy(policy), armPulls(numArms, 0), rewardSum(numArms, 0.0), rewardSquares(numArms, 0.0), totalPulls(0), rewardScale(0.0) {}
+
+size_t OperatorBandit::select(Random& random) const {
+    // Every arm is tried once before the statistics are trusted
+    for (size_t arm = 0; arm < armPulls.size(); ++arm) {
+        if (armPulls[arm] == 0) {
+            return arm;
+        }
+    }
+
+    size_t bestArm = 0;
+    double bestScore = -1.0;
+    for (size_t arm = 0; arm < armPulls.size(); ++arm) {
+        double n = static_cast<double>(armPulls[arm]);
+        double scale = rewardScale > 0.0 ? rewardScale : 1.0;
+        double mean = rewardSum[arm] / n / scale;
+        double score;
+        if (policy == BANDIT_UCB) {
+            score = mean + std::sqrt(2.0 * std::log(static_cast<double>(totalPulls)) / n);
+        } else {
+            // Posterior of the mean under a Gaussian reward model with the sample variance; the floor
+            // keeps arms that were never rewarded explorable
+            double variance = std::max(rewardSquares[arm] / n / (scale * scale) - mean * mean, 0.0) + kVarianceFloor;
+            double u1 = std::max(random.uniform(), 1e-300);
+            double u2 = random.uniform();
+            double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+            score = mean + normal * std::sqrt(variance / n);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestArm = arm;
+        }
+    }
+    return bestArm;
+}
+
+void OperatorBandit::update(size_t arm, double improvement, double seconds) {
+    double reward = std::max(improvement, 0.0) / std::max(seconds, kMinSeconds);
+    armPulls[arm]++;
+    totalPulls++;
+    rewardSum[arm] += reward;
+    rewardSquares[arm] += reward * reward;
+    rewardScale = std::max(rewardScale, reward);
+}
+
+size_t OperatorBandit::pulls(size_t arm) const {
+    return armPulls[arm];
+}
+
+double OperatorBandit::meanReward(size_t arm) const {
+    return armPulls[arm] > 0 ? rewardSum[arm] / armPulls[arm] : 0.0;
+}
+
+void OperatorBandit::save(CheckpointWriter& out) const {
+    std::vector<uint64_t> pulls(armPulls.begin(), armPulls.end());
+    out.putVector(pulls);
+    out.putVector(rewardSum);
+    out.putVector(rewardSquares);
+    out.put(rewardScale);
+}
+
+bool OperatorBandit::load(CheckpointReader& in) {
+    std::vector<uint64_t> pulls;
+    std::vector<double> sums, squares;
+    if (!in.getVector(pulls) || !in.getVector(sums) || !in.getVector(squares) || !in.get(rewardScale) ||
+        pulls.size() != armPulls.size() || sums.size() != armPulls.size() || squares.size() != armPulls.size()) {
+        return false;
+    }
+    armPulls.assign(pulls.begin(), pulls.end());
+    rewardSum = sums;
+    rewardSquares = squares;
+    totalPulls = 0;
+    for (size_t count : armPulls) {
+        totalPulls += count;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef OPERATOR_BANDIT_HPP
+#define OPERATOR_BANDIT_HPP
+
+#include "Checkpoint.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <vector>
+
+enum BanditPolicy {
+    BANDIT_UCB,       // UCB1 on normalized rewards
+    BANDIT_THOMPSON   // Gaussian Thompson sampling on normalized rewards
+};
+
+// Chooses between move operators by their observed reward: the cost improvement a move achieved per
+// estimator second it consumed. Rewards are normalized by the largest one seen so far.
+class OperatorBandit {
+public:
+    OperatorBandit(size_t numArms, BanditPolicy policy);
+
+    size_t select(Random& random) const;
+    void update(size_t arm, double improvement, double seconds);
+
+    size_t pulls(size_t arm) const;
+    double meanReward(size_t arm) const;  // Improvement per estimator second
+
+    void save(CheckpointWriter& out) const;
+    bool load(CheckpointReader& in);
+
+private:
+    BanditPolicy policy;
+    std::vector<size_t> armPulls;
+    std::vector<double> rewardSum;
+    std::vector<double> rewardSquares;
+    size_t totalPulls;
+    double rewardScale;
+};
+
+#endif // OPERATOR_BANDIT_HPP
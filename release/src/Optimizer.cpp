@@ -1,114 +1,835 @@
 #include "Optimizer.hpp"
 #include "NetlistWriter.hpp"
+#include "TemperatureLadder.hpp"
+#include "GreedySweep.hpp"
+#include "ParetoPruner.hpp"
+#include "BatchMoveSearch.hpp"
+#include "GeneticSearch.hpp"
+#include "TabuSearch.hpp"
+#include "ConePartitioner.hpp"
+#include "Checkpoint.hpp"
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
-#include <ctime>
 #include <limits>
 #include <unordered_map>
 #include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <deque>
+#include <future>
+#include <sys/stat.h>
+
+static const double kLadderSpan = 1e-3;     // Coldest to hottest temperature ratio of the initial ladder
+static const int kLadderAdaptRounds = 20;   // Exchange rounds between ladder adaptations
+static const double kPartitionFinalTemp = 1e-3;  // Final to initial temperature ratio of the partition chains
+static const int kDeltaCheckInterval = 200;   // Steps between measurements of delta-tracked costs
+static const double kDeltaDriftTolerance = 1e-4;  // Relative drift of a delta-tracked cost that ends delta evaluation
+static const uint32_t kCheckpointMagic = 0x4b43504e;  // "NPCK"
+static const uint32_t kCheckpointVersion = 2;
+static const size_t kCalibrationMoves = 32;   // Uphill moves that calibrate the adaptive initial temperature
+
+// Create the cost cache directory and name the cache file for this design/library/estimator triple
+static std::string costCacheFile(const OptimizerConfig& config, const MappingHasher& hasher,
+                                 const std::string& cellLibraryFile, const std::string& costEstimator) {
+    if (config.cacheDir.empty()) {
+        return "";
+    }
+    mkdir(config.cacheDir.c_str(), 0755);
+    return CostCache::diskFileName(config.cacheDir, hasher.netlistFingerprint(), cellLibraryFile, costEstimator);
+}
 
 // Constructor definition
 Optimizer::Optimizer(const Netlist& netlist, const std::unordered_map<std::string, std::vector<std::string>>& gateMapping,
-                     const std::string& cellLibraryFile, const std::string& outputFile, const std::string& costEstimator)
-    : netlist(netlist), gateMapping(gateMapping), cellLibraryFile(cellLibraryFile), outputFile(outputFile), costEstimator(costEstimator) {
-    // Initialize random seed
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-
+                     const std::vector<Cell>& cells, const std::string& cellLibraryFile, const std::string& outputFile, const std::string& costEstimator,
+                     const OptimizerConfig& config)
+    : netlist(netlist), cellTable(netlist, cells, gateMapping), graph(netlist), current(), bestCost(std::numeric_limits<float>::max()),
+      seed(config.seed != 0 ? config.seed : Random::timeSeed()), random(seed), cellLibraryFile(cellLibraryFile), outputFile(outputFile), costEstimator(costEstimator), config(config),
+      estimatorPool(netlist, cellTable, cellLibraryFile, costEstimator,
+                    config.scratchDir.empty() ? outputFile + ".work" : config.scratchDir, config.numWorkers),
+      mappingHasher(netlist, cellTable),
+      costCache(config.cacheCapacity, costCacheFile(config, mappingHasher, cellLibraryFile, costEstimator), config.diskCacheCapacity),
+      surrogate(netlist, cellTable, config.surrogateRefit) {
     // Initialize the gate to cell mapping
-    for (const auto& gate : netlist.gates) {
-        auto it = gateMapping.find(gate.type);
-        if (it != gateMapping.end() && !it->second.empty()) {
-            gateToCellMapping[gate.name] = it->second[0]; // Assign the first possible cell for initial mapping
+    current.assignment = CellAssignment(netlist.gates.size());
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        const std::vector<uint16_t>& possibleCells = cellTable.candidates(i);
+        if (!possibleCells.empty()) {
+            current.assignment.set(i, possibleCells[0]); // Assign the first possible cell for initial mapping
         } else {
-            std::cerr << "Warning: No mapping found for gate type " << gate.type << std::endl;
+            std::cerr << "Warning: No mapping found for gate type " << netlist.gates[i].type << std::endl;
         }
     }
 }
 
 // Function to generate a random neighbor with domain-specific knowledge
-void Optimizer::getNeighbor(std::unordered_map<std::string, std::string>& neighborMapping) {
-    neighborMapping = gateToCellMapping;
-    int index = std::rand() % netlist.gates.size();
-    const auto& gate = netlist.gates[index];
-    auto it = gateMapping.find(gate.type);
-    if (it != gateMapping.end() && !it->second.empty()) {
-        const std::vector<std::string>& possibleCells = it->second;
-        if (possibleCells.size() > 1) {
-            std::string currentCell = neighborMapping[gate.name];
-            std::string newCell;
+void Optimizer::getNeighbor(const SearchState& from, Random& rng, Candidate& neighbor, const std::vector<size_t>* gates) {
+    if (!moveOperators.empty() && gates == nullptr) {
+        neighbor.moveOperator = static_cast<int>(operatorBandit->select(rng));
+        moveOperators[neighbor.moveOperator]->propose(from.assignment, bestAssignment, rng, neighbor.moves);
+    } else {
+        size_t index = gates != nullptr ? (*gates)[rng.below(gates->size())] : rng.below(netlist.gates.size());
+        const std::vector<uint16_t>& possibleCells = cellTable.candidates(index);
+        if (possibleCells.size() > 1 && from.assignment[index] != kNoCell) {
+            uint16_t currentCell = from.assignment[index];
+            uint16_t newCell;
             size_t attempts = 0;
             do {
-                newCell = possibleCells[std::rand() % possibleCells.size()];
+                newCell = possibleCells[rng.below(possibleCells.size())];
                 attempts++;
             } while (newCell == currentCell && attempts < possibleCells.size());
             if (newCell != currentCell) {
-                neighborMapping[gate.name] = newCell;
+                CellMove move;
+                move.gate = static_cast<uint32_t>(index);
+                move.oldCell = currentCell;
+                move.newCell = newCell;
+                neighbor.moves.push_back(move);
             }
         }
     }
+    completeCandidate(from, neighbor);
+}
+
+void Optimizer::completeCandidate(const SearchState& from, Candidate& neighbor) {
+    neighbor.key = from.key;
+    neighbor.features = from.features;
+    for (const auto& move : neighbor.moves) {
+        neighbor.key = mappingHasher.update(neighbor.key, move);
+        if (!neighbor.features.empty()) {
+            surrogate.applyMove(neighbor.features, move);
+        }
+    }
+}
+
+// Function to draw several neighbors and keep the one the surrogate model predicts to be cheapest
+void Optimizer::getScreenedNeighbor(const SearchState& from, Random& rng, Candidate& neighbor, const std::vector<size_t>* gates) {
+    getNeighbor(from, rng, neighbor, gates);
+    if (config.surrogateScreen <= 1 || !surrogate.ready()) {
+        return;
+    }
+    double bestPrediction = surrogate.predict(neighbor.features);
+    for (size_t i = 1; i < config.surrogateScreen; ++i) {
+        Candidate other;
+        getNeighbor(from, rng, other, gates);
+        double prediction = surrogate.predict(other.features);
+        if (prediction < bestPrediction) {
+            bestPrediction = prediction;
+            neighbor = std::move(other);
+        }
+    }
+}
+
+// Function to probe the estimator's cost structure around the current mapping and switch to
+// exact delta evaluation when the cost is additive over gates
+void Optimizer::probeCostStructure() {
+    // The probe runs through the cache and the evaluation limit like the search, and is shrunk until
+    // it leaves the search at least half of the evaluations still left
+    size_t numPairs = config.probePairs;
+    while (numPairs > 0 && EstimatorProbe::maxEvaluations(numPairs) > remainingEvaluations() / 2) {
+        numPairs /= 2;
+    }
+    if (numPairs == 0) {
+        std::cout << "Estimator probe skipped, the evaluation limit leaves no room for it" << std::endl;
+        return;
+    }
+    EstimatorProbe probe(netlist, cellTable, [this](const std::vector<CellAssignment>& batch) { return evaluateBatch(batch); }, numPairs,
+                         random.split());
+    ProbeReport report = probe.run(current.assignment, current.cost);
+    std::cout << "Estimator probe: " << report.evaluations << " evaluations, model = " << EstimatorProbe::modelName(report.model)
+              << (report.positionIndependent ? " (position independent)" : "")
+              << ", RMS error additive = " << report.additiveError << ", pairwise = " << report.pairwiseError
+              << ", max-path = " << report.maxPathError << ", tolerance = " << report.tolerance << ", " << report.criticalPairs
+              << " critical pairs" << std::endl;
+    if (report.model != COST_MODEL_ADDITIVE) {
+        return;
+    }
+
+    exactDelta = true;
+    positionIndependent = report.positionIndependent;
+    deltaBase = current.assignment;
+    gateDeltas.assign(netlist.gates.size(), std::unordered_map<uint16_t, float>());
+    for (const auto& move : report.singles) {
+        learnDelta(move.gate, move.cell, move.delta);
+    }
+}
+
+// Function to give the steps between measurements of the tracked search costs: the revalidation
+// interval, or a default one while the costs are derived from deltas
+int Optimizer::remeasureInterval() const {
+    if (config.revalidateInterval > 0) {
+        return config.revalidateInterval;
+    }
+    return exactDelta ? kDeltaCheckInterval : 0;
+}
+
+// Function to measure the tracked cost of a search state again. A delta-tracked cost that has
+// drifted from the measurement shows that the probe misjudged the cost as additive, so delta
+// evaluation is switched off and the best cost, which may be delta-derived too, is measured again.
+void Optimizer::remeasureCost(SearchState& state) {
+    if (remainingEvaluations() == 0) {
+        return;
+    }
+    float measured = estimatorPool.evaluate(state.assignment);
+    costCache.insert(state.key, measured);
+    if (exactDelta && measured < std::numeric_limits<float>::max() &&
+        std::fabs(measured - state.cost) > kDeltaDriftTolerance * std::max(std::fabs(measured), 1.0f)) {
+        std::cout << "Delta-tracked cost " << state.cost << " drifted from the measured " << measured
+                  << ", switching off exact delta evaluation" << std::endl;
+        exactDelta = false;
+        // Past the evaluation limit the best cost keeps its delta-tracked value
+        float measuredBest = bestAssignment.size() > 0 ? calculateCost(bestAssignment) : std::numeric_limits<float>::max();
+        if (measuredBest < std::numeric_limits<float>::max()) {
+            bestCost = measuredBest;
+            updateCostFile(bestCost);
+        }
+    }
+    state.cost = measured;
+}
+
+bool Optimizer::lookupDelta(size_t gate, uint16_t cell, float& delta) const {
+    if (cell == deltaBase[gate]) {
+        delta = 0.0f;
+        return true;
+    }
+    auto it = gateDeltas[gate].find(cell);
+    if (it != gateDeltas[gate].end()) {
+        delta = it->second;
+        return true;
+    }
+    if (positionIndependent) {
+        auto shared = cellDeltas.find((static_cast<uint32_t>(deltaBase[gate]) << 16) | cell);
+        if (shared != cellDeltas.end()) {
+            delta = shared->second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Optimizer::learnDelta(size_t gate, uint16_t cell, float delta) {
+    gateDeltas[gate][cell] = delta;
+    if (positionIndependent) {
+        cellDeltas[(static_cast<uint32_t>(deltaBase[gate]) << 16) | cell] = delta;
+    }
 }
 
 // Function to calculate the cost of the current netlist
-float Optimizer::calculateCost(const std::unordered_map<std::string, std::string>& mapping) {
-    // Write the current netlist to the output file with the given mapping
-    NetlistWriter netlistWriter;
-    netlistWriter.writeNetlist(netlist, mapping, outputFile);
-    return runCostEstimator();
+float Optimizer::calculateCost(const CellAssignment& assignment) {
+    MappingKey key = mappingHasher.hash(assignment);
+    float cost;
+    if (costCache.lookup(key, cost)) {
+        return cost;
+    }
+    // Past the evaluation limit the mapping fails like an estimator error instead of running
+    if (remainingEvaluations() == 0) {
+        return std::numeric_limits<float>::max();
+    }
+    // Candidates are written to a worker's scratch directory, outputFile only ever holds the best netlist
+    cost = estimatorPool.evaluate(assignment);
+    costCache.insert(key, cost);
+    return cost;
 }
 
-// Enhanced Simulated Annealing function
-void Optimizer::simulatedAnnealing() {
-    float initialTemp = 1000.0f;
-    float alpha = 0.95f;  // Slower cooling rate initially
+// Function to give the estimator runs left under the evaluation limit, counting queued requests
+size_t Optimizer::remainingEvaluations() const {
+    if (config.maxEvaluations == 0) {
+        return std::numeric_limits<size_t>::max();
+    }
+    size_t committed = estimatorPool.committedEvaluations();
+    return committed < config.maxEvaluations ? config.maxEvaluations - committed : 0;
+}
 
-    float currentTemp = initialTemp;
+std::vector<float> Optimizer::evaluateBatch(const std::vector<CellAssignment>& assignments) {
+    std::vector<float> costs(assignments.size(), std::numeric_limits<float>::max());
+    std::vector<MappingKey> keys(assignments.size());
+    std::vector<CellAssignment> misses;
+    std::vector<size_t> missIndex;
+    for (size_t i = 0; i < assignments.size(); ++i) {
+        keys[i] = mappingHasher.hash(assignments[i]);
+        if (!costCache.lookup(keys[i], costs[i])) {
+            misses.push_back(assignments[i]);
+            missIndex.push_back(i);
+        }
+    }
+    // A batch stops at the evaluation limit; the mappings past it keep the failure cost, which the
+    // engines already skip
+    if (misses.size() > remainingEvaluations()) {
+        misses.resize(remainingEvaluations());
+        missIndex.resize(misses.size());
+    }
+    if (!misses.empty()) {
+        std::vector<float> missCosts = estimatorPool.evaluateBatch(misses);
+        for (size_t m = 0; m < misses.size(); ++m) {
+            costs[missIndex[m]] = missCosts[m];
+            costCache.insert(keys[missIndex[m]], missCosts[m]);
+        }
+    }
+    return costs;
+}
 
-    // Initial solution
-    float bestCost = calculateCost(gateToCellMapping);
-    std::unordered_map<std::string, std::string> bestMapping = gateToCellMapping;
+void Optimizer::submitCandidate(SearchState& from, Candidate& candidate) {
+    // Mappings that were costed before, or whose cost follows from known deltas, never reach the estimator
+    candidate.cached = costCache.lookup(candidate.key, candidate.cachedCost);
+    if (!candidate.cached && exactDelta && !candidate.moves.empty()) {
+        // The cost is additive, so the deltas of moves on distinct gates add up
+        float total = 0.0f;
+        bool known = true;
+        for (const auto& move : candidate.moves) {
+            float oldDelta, newDelta;
+            if (!lookupDelta(move.gate, move.oldCell, oldDelta) || !lookupDelta(move.gate, move.newCell, newDelta)) {
+                known = false;
+                break;
+            }
+            total += newDelta - oldDelta;
+        }
+        if (known) {
+            candidate.cached = true;
+            candidate.cachedCost = from.cost + total;
+        }
+    }
+    if (!candidate.cached && remainingEvaluations() == 0) {
+        // Past the evaluation limit the candidate fails like an estimator error instead of running
+        candidate.cached = true;
+        candidate.cachedCost = std::numeric_limits<float>::max();
+    }
+    if (!candidate.cached) {
+        // The pool copies the assignment, so the moves are only applied for the duration of the call
+        for (const auto& move : candidate.moves) {
+            from.assignment.apply(move);
+        }
+        candidate.cost = estimatorPool.evaluateAsync(from.assignment);
+        for (auto it = candidate.moves.rbegin(); it != candidate.moves.rend(); ++it) {
+            from.assignment.undo(*it);
+        }
+    }
+}
 
+float Optimizer::collectCandidate(const SearchState& from, Candidate& candidate) {
+    float cost = candidate.cached ? candidate.cachedCost : candidate.cost.get();
+    if (candidate.moveOperator >= 0 && cost < std::numeric_limits<float>::max()) {
+        double seconds = candidate.cached ? 0.0 : estimatorPool.metrics().meanSeconds(PHASE_TOTAL);
+        operatorBandit->update(candidate.moveOperator, from.cost - cost, seconds);
+    }
+    if (candidate.cached) {
+        return cost;
+    }
+    costCache.insert(candidate.key, cost);
+    if (!candidate.features.empty()) {
+        surrogate.addSample(candidate.features, cost);
+    }
+    float oldDelta;
+    if (exactDelta && candidate.moves.size() == 1 && cost < std::numeric_limits<float>::max() &&
+        lookupDelta(candidate.moves[0].gate, candidate.moves[0].oldCell, oldDelta)) {
+        learnDelta(candidate.moves[0].gate, candidate.moves[0].newCell, oldDelta + cost - from.cost);
+    }
+    return cost;
+}
+
+void Optimizer::acceptCandidate(SearchState& state, Candidate& candidate, float cost) {
+    for (const auto& move : candidate.moves) {
+        state.assignment.apply(move);
+    }
+    state.key = candidate.key;
+    state.features = std::move(candidate.features);
+    state.cost = cost;
+}
+
+// Function to drop Pareto-dominated cells from the candidates of every gate type. In strict mode a
+// dominated cell stays when mapping its whole type to it is cheaper than mapping it to the dominating
+// cell, i.e. when the estimator does not reward smaller attributes there.
+void Optimizer::pruneCells() {
+    ParetoPruner pruner(cellTable);
+    std::vector<std::vector<size_t>> typeGates(cellTable.numTypes());
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        typeGates[cellTable.typeOf(i)].push_back(i);
+    }
+    auto uniform = [&](size_t type, uint16_t cell) -> CellAssignment {
+        CellAssignment assignment = current.assignment;
+        for (size_t gate : typeGates[type]) {
+            assignment.set(gate, cell);
+        }
+        return assignment;
+    };
+
+    std::vector<bool> keep(cellTable.numCells(), true);
+    std::vector<uint16_t> dominated;
+    for (size_t t = 1; t < cellTable.numTypes(); ++t) {
+        for (uint16_t cell : cellTable.typeCells(t)) {
+            if (pruner.dominator(cell) != kNoCell) {
+                keep[cell] = false;
+                dominated.push_back(cell);
+            }
+        }
+    }
+
+    size_t restored = 0;
+    if (config.cellPruning == "strict" && !dominated.empty()) {
+        std::vector<CellAssignment> probes;
+        std::vector<size_t> probeCell;
+        for (size_t t = 1; t < cellTable.numTypes(); ++t) {
+            for (uint16_t cell : cellTable.typeCells(t)) {
+                if (!keep[cell] && !typeGates[t].empty()) {
+                    probes.push_back(uniform(t, cell));
+                    probes.push_back(uniform(t, pruner.dominator(cell)));
+                    probeCell.push_back(cell);
+                }
+            }
+        }
+        std::vector<float> costs = evaluateBatch(probes);
+        for (size_t p = 0; p < probeCell.size(); ++p) {
+            float prunedCost = costs[2 * p];
+            float dominatorCost = costs[2 * p + 1];
+            double tolerance = std::max(1e-5 * std::fabs(dominatorCost), 1e-5);
+            if (dominatorCost > prunedCost + tolerance) {
+                keep[probeCell[p]] = true;
+                restored++;
+            }
+        }
+    }
+
+    size_t before = 0, after = 0;
+    for (size_t t = 1; t < cellTable.numTypes(); ++t) {
+        std::vector<uint16_t> cells;
+        for (uint16_t cell : cellTable.typeCells(t)) {
+            if (keep[cell]) {
+                cells.push_back(cell);
+            }
+        }
+        before += cellTable.typeCells(t).size();
+        after += cells.size();
+        cellTable.setTypeCells(t, cells);
+    }
+    for (size_t i = 0; i < current.assignment.size(); ++i) {
+        uint16_t cell = current.assignment[i];
+        if (cell != kNoCell && !keep[cell]) {
+            current.assignment.set(i, pruner.dominator(cell));
+        }
+    }
+    std::cout << "Cell pruning: " << before << " -> " << after << " candidate cells";
+    if (config.cellPruning == "strict") {
+        std::cout << " (" << restored << " dominated cells kept after probing)";
+    }
+    std::cout << std::endl;
+}
+
+// Function to cost the initial mapping and set up the optional surrogate and probe
+void Optimizer::initializeSearch() {
+    std::cout << "Random seed = " << seed << std::endl;
+    if (config.cellPruning != "off") {
+        pruneCells();
+    }
+    current.cost = calculateCost(current.assignment);
+    if (config.initialization == "sweep") {
+        float initialCost = current.cost;
+        GreedySweep sweep(cellTable, [this](const std::vector<CellAssignment>& batch) { return evaluateBatch(batch); },
+                          config.sweepRounds);
+        sweep.run(current.assignment, current.cost);
+        std::cout << "Sweep initialization: cost " << initialCost << " -> " << current.cost << " in " << sweep.evaluations()
+                  << " evaluations and " << sweep.rounds() << " descent rounds" << std::endl;
+    }
+    current.key = mappingHasher.hash(current.assignment);
+    setUpMoveOperators();
+    if (config.surrogateScreen > 1) {
+        current.features = surrogate.features(current.assignment);
+        surrogate.addSample(current.features, current.cost);
+    }
+
+    if (config.probePairs > 0) {
+        probeCostStructure();
+    }
+
+    bestAssignment = current.assignment;
+    bestCost = current.cost;
     // Write the initial best cost to the cost_output.txt file
     updateCostFile(bestCost);
+}
 
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+// Function to create the move operators and their scheduler, after pruning since the operators keep
+// per-type cell orders
+void Optimizer::setUpMoveOperators() {
+    if (config.movePolicy != "single") {
+        int delayAttribute = config.delayAttribute;
+        if (delayAttribute < 0 && estimatorPool.mockConfig()) {
+            delayAttribute = static_cast<int>(estimatorPool.mockConfig()->delayAttribute);
+        }
+        moveOperators = createMoveOperators(cellTable, graph, delayAttribute);
+        operatorBandit.reset(new OperatorBandit(moveOperators.size(), config.movePolicy == "thompson" ? BANDIT_THOMPSON : BANDIT_UCB));
+    }
+}
 
-    int iteration = 0;
-    int resetCounter = 0;
+// Function to write the complete search state to the checkpoint file: the mappings, the pruned cell
+// lists, the random stream, the budget, the caches and learned models, and the annealer's own state
+// including the neighbors still in flight, which a resumed run submits again
+void Optimizer::saveCheckpoint(const SearchBudget& budget, const AnnealingState& state) {
+    CheckpointWriter out(config.checkpointFile);
+    out.put(kCheckpointMagic);
+    out.put(kCheckpointVersion);
+    out.put(mappingHasher.netlistFingerprint());
+    out.put<uint64_t>(cellTable.numGates());
+    out.put<uint64_t>(cellTable.numCells());
+    out.putString(config.engine);
+    out.putString(costEstimator);
+    out.putString(cellLibraryFile);
+    out.putString(config.movePolicy);
+
+    out.put(seed);
+    random.save(out);
+    out.put<uint64_t>(estimatorPool.evaluations());
+    budget.save(out);
+    out.put<uint64_t>(cellTable.numTypes());
+    for (size_t type = 0; type < cellTable.numTypes(); ++type) {
+        out.putVector(cellTable.typeCells(type));
+    }
+    out.putVector(current.assignment.cells());
+    out.put(current.cost);
+    out.putVector(bestAssignment.cells());
+    out.put(bestCost);
+
+    out.put(exactDelta);
+    out.put(positionIndependent);
+    out.putVector(deltaBase.cells());
+    out.put<uint64_t>(gateDeltas.size());
+    for (const auto& deltas : gateDeltas) {
+        out.put<uint64_t>(deltas.size());
+        for (const auto& entry : deltas) {
+            out.put(entry.first);
+            out.put(entry.second);
+        }
+    }
+    out.put<uint64_t>(cellDeltas.size());
+    for (const auto& entry : cellDeltas) {
+        out.put(entry.first);
+        out.put(entry.second);
+    }
+    costCache.save(out);
+    surrogate.save(out);
+    if (operatorBandit) {
+        operatorBandit->save(out);
+    }
+
+    out.put(state.temperature);
+    out.put(state.alpha);
+    out.put(state.iteration);
+    out.put(state.resetCounter);
+    state.cooling.save(out);
+    out.putVector(state.pendingOperators);
+    for (const auto& moves : state.pendingMoves) {
+        out.putVector(moves);
+    }
+    if (!out.commit()) {
+        std::cerr << "Error: Could not write checkpoint " << config.checkpointFile << std::endl;
+    }
+}
+
+bool Optimizer::loadCheckpoint(SearchBudget& budget, AnnealingState& state) {
+    CheckpointReader in(config.checkpointFile);
+    auto fail = [this](const char* problem) {
+        std::cerr << "Error: Checkpoint " << config.checkpointFile << " " << problem << "." << std::endl;
+        return false;
+    };
+    if (!in.isOpen()) {
+        return fail("could not be opened");
+    }
+    // Cell ids index the cell table and the hash seeds, and the writer prints them, so every id read has
+    // to be a cell the gate may use; only gates without candidates carry kNoCell
+    std::vector<std::vector<uint16_t>> typeCells;
+    auto inList = [](const std::vector<uint16_t>& cells, uint16_t cell) { return std::find(cells.begin(), cells.end(), cell) != cells.end(); };
+    auto validCell = [&](size_t gate, uint16_t cell) {
+        const std::vector<uint16_t>& cells = typeCells[cellTable.typeOf(gate)];
+        return cells.empty() ? cell == kNoCell : inList(cells, cell);
+    };
+    auto validCells = [&](const std::vector<uint16_t>& cells) {
+        for (size_t gate = 0; gate < cells.size(); ++gate) {
+            if (!validCell(gate, cells[gate])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto toAssignment = [this](const std::vector<uint16_t>& cells) {
+        CellAssignment assignment(cells.size());
+        for (size_t gate = 0; gate < cells.size(); ++gate) {
+            assignment.set(gate, cells[gate]);
+        }
+        return assignment;
+    };
+
+    uint32_t magic, version;
+    uint64_t fingerprint, numGates, numCells;
+    std::string engine, estimator, library, movePolicy;
+    if (!in.get(magic) || magic != kCheckpointMagic || !in.get(version) || version != kCheckpointVersion) {
+        return fail("is not a checkpoint of this version");
+    }
+    if (!in.get(fingerprint) || !in.get(numGates) || !in.get(numCells) || !in.getString(engine) || !in.getString(estimator) ||
+        !in.getString(library) || !in.getString(movePolicy)) {
+        return fail("is truncated");
+    }
+    if (fingerprint != mappingHasher.netlistFingerprint() || numGates != cellTable.numGates() || numCells != cellTable.numCells() ||
+        engine != config.engine || estimator != costEstimator || library != cellLibraryFile || movePolicy != config.movePolicy) {
+        return fail("was written for a different design, library, estimator, engine or move policy");
+    }
+
+    uint64_t evaluations, numTypes;
+    bool valid = in.get(seed) && random.load(in) && in.get(evaluations) && budget.load(in) && in.get(numTypes) &&
+                 numTypes == cellTable.numTypes();
+    // The pruned cell lists of a type keep some of its cells, never other types' or none at all
+    typeCells.resize(valid ? numTypes : 0);
+    for (size_t type = 0; type < typeCells.size(); ++type) {
+        const std::vector<uint16_t>& cells = typeCells[type];
+        valid = valid && in.getVector(typeCells[type]) && cells.empty() == cellTable.typeCells(type).empty() &&
+                std::all_of(cells.begin(), cells.end(), [&](uint16_t cell) { return inList(cellTable.typeCells(type), cell); });
+    }
+    std::vector<uint16_t> currentCells, bestCells, baseCells;
+    valid = valid && in.getVector(currentCells) && currentCells.size() == numGates && validCells(currentCells) && in.get(current.cost) &&
+            in.getVector(bestCells) && bestCells.size() == numGates && validCells(bestCells) && in.get(bestCost);
+
+    uint64_t numDeltaGates, count;
+    valid = valid && in.get(exactDelta) && in.get(positionIndependent) && in.getVector(baseCells) &&
+            (baseCells.empty() || baseCells.size() == numGates) && validCells(baseCells) && in.get(numDeltaGates) &&
+            (numDeltaGates == 0 || numDeltaGates == numGates);
+    if (!valid) {
+        return fail("is truncated or corrupt");
+    }
+    for (size_t type = 0; type < numTypes; ++type) {
+        cellTable.setTypeCells(type, typeCells[type]);
+    }
+    gateDeltas.assign(numDeltaGates, std::unordered_map<uint16_t, float>());
+    for (size_t gate = 0; gate < gateDeltas.size(); ++gate) {
+        valid = valid && in.get(count);
+        for (uint64_t i = 0; valid && i < count; ++i) {
+            uint16_t cell;
+            float delta;
+            valid = in.get(cell) && in.get(delta) && cell != kNoCell && validCell(gate, cell);
+            gateDeltas[gate][cell] = delta;
+        }
+    }
+    valid = valid && in.get(count);
+    for (uint64_t i = 0; valid && i < count; ++i) {
+        uint32_t pair;
+        float delta;
+        valid = in.get(pair) && in.get(delta) && (pair >> 16) < cellTable.numCells() && (pair & 0xffff) < cellTable.numCells();
+        cellDeltas[pair] = delta;
+    }
+    valid = valid && costCache.load(in) && surrogate.load(in);
+    setUpMoveOperators();
+    if (operatorBandit) {
+        valid = valid && operatorBandit->load(in);
+    }
+
+    valid = valid && in.get(state.temperature) && in.get(state.alpha) && in.get(state.iteration) && in.get(state.resetCounter) &&
+            state.cooling.load(in) && in.getVector(state.pendingOperators);
+    state.pendingMoves.assign(valid ? state.pendingOperators.size() : 0, std::vector<CellMove>());
+    for (int op : state.pendingOperators) {
+        valid = valid && op >= -1 && op < static_cast<int>(moveOperators.size());
+    }
+    for (auto& moves : state.pendingMoves) {
+        valid = valid && in.getVector(moves);
+        for (size_t i = 0; valid && i < moves.size(); ++i) {
+            const CellMove& move = moves[i];
+            valid = move.gate < numGates && move.oldCell != kNoCell && move.newCell != kNoCell && validCell(move.gate, move.oldCell) &&
+                    validCell(move.gate, move.newCell);
+        }
+    }
+    if (!valid) {
+        return fail("is truncated or corrupt");
+    }
+
+    current.assignment = toAssignment(currentCells);
+    current.key = mappingHasher.hash(current.assignment);
+    if (config.surrogateScreen > 1) {
+        current.features = surrogate.features(current.assignment);
+    }
+    bestAssignment = toAssignment(bestCells);
+    deltaBase = toAssignment(baseCells);
+    estimatorPool.restoreEvaluations(evaluations);
+    std::cout << "Random seed = " << seed << std::endl;
+    std::cout << "Resumed from " << config.checkpointFile << " at iteration " << state.iteration << " after "
+              << budget.elapsedSeconds() << " s and " << evaluations << " evaluations, best cost = " << bestCost << std::endl;
+    updateCostFile(bestCost);
+    return true;
+}
+
+// Function to record a better mapping and save it together with its cost
+void Optimizer::updateBest(const CellAssignment& assignment, float cost, SearchBudget& budget) {
+    if (cost >= bestCost) {
+        return;
+    }
+    bestCost = cost;
+    bestAssignment = assignment;
+    budget.improve(bestCost, estimatorPool.evaluations());
+    // Update the cost_output.txt with the best cost
+    updateCostFile(bestCost);
+    // Save the best netlist periodically
+    NetlistWriter netlistWriter;
+    netlistWriter.writeNetlist(netlist, cellTable.names(), bestAssignment.cells(), outputFile);
+}
+
+// Function to check the stopping rules, which also end a search whose estimator cannot be run
+bool Optimizer::exhausted(SearchBudget& budget) {
+    if (estimatorPool.failed()) {
+        budget.abort("estimator failure");
+    }
+    return budget.exhausted(estimatorPool.evaluations());
+}
+
+// Function to set up the stopping rules, falling back to the gate count policy for the time limit
+SearchBudget Optimizer::createBudget() const {
+    double timeLimit = config.timeLimit > 0.0 ? config.timeLimit : SearchBudget::policyTimeLimit(netlist.gates.size());
+    std::cout << "Budget: " << timeLimit << " s";
+    if (config.maxEvaluations > 0) {
+        std::cout << ", " << config.maxEvaluations << " evaluations";
+    }
+    if (config.stallEvaluations > 0) {
+        std::cout << ", stop after " << config.stallEvaluations << " evaluations without improvement";
+    }
+    std::cout << std::endl;
+    return SearchBudget(timeLimit, config.maxEvaluations, config.stallEvaluations, config.stallEpsilon);
+}
+
+// Function to report the run statistics and make the best mapping current
+void Optimizer::finishSearch(const SearchBudget& budget) {
+    std::cout << "Stopped on " << budget.reason() << " after " << budget.elapsedSeconds() << " s and "
+              << estimatorPool.evaluations() << " evaluations" << std::endl;
+    std::cout << "Cost cache: " << costCache.hits() << " hits, " << costCache.misses() << " misses" << std::endl;
+    if (config.surrogateScreen > 1) {
+        std::cout << "Surrogate: " << surrogate.sampleCount() << " samples, mean absolute error " << surrogate.meanAbsoluteError() << std::endl;
+    }
+    for (size_t i = 0; i < moveOperators.size(); ++i) {
+        std::cout << "Move operator " << moveOperators[i]->name() << ": " << operatorBandit->pulls(i)
+                  << " uses, mean improvement per estimator second " << operatorBandit->meanReward(i) << std::endl;
+    }
+    if (!config.metricsFile.empty()) {
+        writeMetrics();
+    }
+
+    // Costs derived from deltas accumulate rounding, so confirm the best one with the estimator
+    if (exactDelta) {
+        float measuredCost = calculateCost(bestAssignment);
+        if (measuredCost < std::numeric_limits<float>::max()) {
+            std::cout << "Best cost from delta evaluation = " << bestCost << ", measured = " << measuredCost << std::endl;
+            bestCost = measuredCost;
+            updateCostFile(bestCost);
+        } else {
+            std::cout << "Best cost from delta evaluation = " << bestCost << ", not measured within the evaluation limit" << std::endl;
+        }
+    }
+
+    // Restore the best mapping
+    current.assignment = bestAssignment;
+    current.key = mappingHasher.hash(bestAssignment);
+    current.features.clear();
+    current.cost = bestCost;
+
+    // Save the final best netlist
+    NetlistWriter netlistWriter;
+    netlistWriter.writeNetlist(netlist, cellTable.names(), bestAssignment.cells(), outputFile);
+}
+
+// Enhanced Simulated Annealing function
+void Optimizer::simulatedAnnealing() {
+    float initialTemp = 1000.0f;
+    AnnealingState state;
+    state.cooling = CoolingSchedule(config.initialAcceptance, kCalibrationMoves);
+    bool adaptive = config.cooling == "adaptive";
+
+    // Initial solution, or the state of an interrupted run
+    SearchBudget budget = createBudget();
+    if (config.resume && std::ifstream(config.checkpointFile).good()) {
+        if (!loadCheckpoint(budget, state)) {
+            checkpointFailed = true;
+            return;
+        }
+    } else {
+        if (config.resume) {
+            std::cout << "No checkpoint " << config.checkpointFile << " to resume, starting a new run" << std::endl;
+        }
+        initializeSearch();
+    }
+
+    float currentTemp = state.temperature;
+    float alpha = state.alpha;  // Slower cooling rate initially
+    int iteration = state.iteration;
+    int resetCounter = state.resetCounter;
     
     auto startTime = std::chrono::steady_clock::now();
-    auto endTime = startTime + std::chrono::hours(3);
+    auto nextMetricsTime = startTime + std::chrono::seconds(config.metricsInterval);
+    auto nextCheckpointTime = startTime + std::chrono::seconds(config.checkpointInterval);
 
-    while (std::chrono::steady_clock::now() < endTime) {
-        iteration++;
-        std::unordered_map<std::string, std::string> neighborMapping;
-        getNeighbor(neighborMapping);
-        float currentCost = calculateCost(gateToCellMapping);
-        float neighborCost = calculateCost(neighborMapping);
+    // Neighbors of the current mapping are evaluated speculatively while earlier ones are being decided
+    size_t pipelineDepth = config.pipelineDepth > 0 ? config.pipelineDepth : estimatorPool.size();
+    std::deque<Candidate> pipeline;
+    for (size_t i = 0; i < state.pendingMoves.size(); ++i) {
+        Candidate candidate;
+        candidate.moves = state.pendingMoves[i];
+        candidate.moveOperator = state.pendingOperators[i];
+        completeCandidate(current, candidate);
+        submitCandidate(current, candidate);
+        pipeline.push_back(std::move(candidate));
+    }
 
-        // Increase the acceptance probability for worse solutions at higher temperatures
-        if (neighborCost < currentCost || std::exp((currentCost - neighborCost) / currentTemp) > (static_cast<float>(std::rand()) / RAND_MAX)) {
-            gateToCellMapping = neighborMapping;
-            currentCost = neighborCost;
+    // Snapshot of the loop state for a checkpoint
+    auto saveAnnealing = [&]() {
+        state.temperature = currentTemp;
+        state.alpha = alpha;
+        state.iteration = iteration;
+        state.resetCounter = resetCounter;
+        state.pendingMoves.clear();
+        state.pendingOperators.clear();
+        for (const auto& candidate : pipeline) {
+            state.pendingMoves.push_back(candidate.moves);
+            state.pendingOperators.push_back(candidate.moveOperator);
         }
+        saveCheckpoint(budget, state);
+    };
 
-        if (currentCost < bestCost) {
-            bestCost = currentCost;
-            bestMapping = gateToCellMapping;
-            // Update the cost_output.txt with the best cost
-            updateCostFile(bestCost);
-            // Save the best netlist periodically
-            NetlistWriter netlistWriter;
-            netlistWriter.writeNetlist(netlist, bestMapping, outputFile);
+    budget.improve(bestCost, estimatorPool.evaluations());
+    while (!exhausted(budget)) {
+        iteration++;
+        // The current cost is carried over from the last accepted move; non-deterministic
+        // estimators can ask for it to be measured again periodically, and delta-tracked costs are
+        // checked against the estimator
+        if (remeasureInterval() > 0 && iteration % remeasureInterval() == 0) {
+            remeasureCost(current);
         }
+        while (pipeline.size() < pipelineDepth) {
+            Candidate candidate;
+            getScreenedNeighbor(current, random, candidate);
+            submitCandidate(current, candidate);
+            pipeline.push_back(std::move(candidate));
+        }
+        Candidate neighbor = std::move(pipeline.front());
+        pipeline.pop_front();
+        float neighborCost = collectCandidate(current, neighbor);
+
+        // Increase the acceptance probability for worse solutions at higher temperatures; the adaptive
+        // schedule is greedy until it has seen an uphill move
+        double temp = adaptive ? state.cooling.temperature() : currentTemp;
+        double delta = static_cast<double>(neighborCost) - current.cost;
+        bool accepted = neighborCost < current.cost || (temp > 0.0 && std::exp(-delta / temp) > random.uniform());
+        if (accepted) {
+            acceptCandidate(current, neighbor, neighborCost);
+            // The remaining speculative neighbors were drawn around the old mapping
+            pipeline.clear();
+            estimatorPool.cancelPending();
+        }
+        if (adaptive && neighborCost < std::numeric_limits<float>::max()) {
+            state.cooling.record(delta, accepted, budget.progress(estimatorPool.evaluations()));
+        }
+
+        updateBest(current.assignment, current.cost, budget);
 
         // Adjust alpha dynamically
         if (iteration % 100 == 0) {  // Output progress every 100 iterations
-            std::cout << "Iteration " << iteration << ": Current cost = " << currentCost << ", Best cost = " << bestCost << std::endl;
-            // Adaptive cooling: Reduce alpha if no improvement
-            if (currentCost == bestCost) {
+            std::cout << "Iteration " << iteration << ": Current cost = " << current.cost << ", Best cost = " << bestCost
+                      << ", Temperature = " << temp << std::endl;
+            if (surrogate.ready()) {
+                std::cout << "Surrogate mean absolute error = " << surrogate.meanAbsoluteError() << std::endl;
+            }
+            if (adaptive) {
+                std::cout << "Acceptance rate = " << state.cooling.acceptanceRate() << ", target = "
+                          << CoolingSchedule::targetRate(budget.progress(estimatorPool.evaluations())) << std::endl;
+            } else if (current.cost == bestCost) {
+                // Adaptive cooling: Reduce alpha if no improvement
                 alpha = std::max(alpha * 0.99f, 0.85f);  // Slow down cooling if stuck
             } else {
                 alpha = 0.95f;  // Reset to the original cooling rate if improvement
@@ -116,23 +837,382 @@ void Optimizer::simulatedAnnealing() {
             }
         }
 
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+
         // Occasionally reset the temperature to escape local minima
-        if (resetCounter > 500) {
-            currentTemp = initialTemp;
-            resetCounter = 0;
-        } else {
-            resetCounter++;
+        if (!adaptive) {
+            if (resetCounter > 500) {
+                currentTemp = initialTemp;
+                resetCounter = 0;
+            } else {
+                resetCounter++;
+            }
+            currentTemp *= alpha;
         }
 
-        currentTemp *= alpha;
+        if (!config.checkpointFile.empty() && std::chrono::steady_clock::now() >= nextCheckpointTime) {
+            saveAnnealing();
+            nextCheckpointTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.checkpointInterval);
+        }
+    }
+    // A final checkpoint lets a resumed finished run stop right away
+    if (!config.checkpointFile.empty()) {
+        saveAnnealing();
     }
 
-    // Restore the best mapping
-    gateToCellMapping = bestMapping;
+    finishSearch(budget);
+}
 
-    // Save the final best netlist
-    NetlistWriter netlistWriter;
-    netlistWriter.writeNetlist(netlist, bestMapping, outputFile);
+// Parallel tempering: replicas at a ladder of temperatures each take one Metropolis step per round,
+// with their neighbors evaluated concurrently on the estimator pool, and periodically exchange states
+// between neighboring temperatures so good states drift down to the cold end
+void Optimizer::parallelTempering() {
+    SearchBudget budget = createBudget();
+    initializeSearch();
+
+    size_t numReplicas = config.replicas > 0 ? config.replicas : std::max<size_t>(estimatorPool.size(), 4);
+    std::vector<SearchState> replicas(numReplicas, current);
+    std::vector<Candidate> candidates(numReplicas);
+    // Placeholder ladder until the first round shows the size of typical uphill moves
+    double fallbackTemp = std::max(1e-2 * std::fabs(current.cost), 1e-6);
+    TemperatureLadder ladder(numReplicas, fallbackTemp * kLadderSpan, fallbackTemp);
+    bool calibrated = false;
+    // Every replica draws its moves and acceptance decisions from its own substream
+    std::vector<Random> streams;
+    for (size_t r = 0; r < numReplicas; ++r) {
+        streams.push_back(random.split());
+    }
+
+    int step = 0;
+    int exchangeRounds = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    auto nextMetricsTime = startTime + std::chrono::seconds(config.metricsInterval);
+
+    budget.improve(bestCost, estimatorPool.evaluations());
+    while (!exhausted(budget)) {
+        step++;
+        if (remeasureInterval() > 0 && step % remeasureInterval() == 0) {
+            for (auto& replica : replicas) {
+                remeasureCost(replica);
+            }
+        }
+        // Submit one neighbor per replica before waiting, so the workers evaluate them side by side
+        for (size_t r = 0; r < numReplicas; ++r) {
+            candidates[r] = Candidate();
+            getScreenedNeighbor(replicas[r], streams[r], candidates[r]);
+            submitCandidate(replicas[r], candidates[r]);
+        }
+        std::vector<float> costs(numReplicas);
+        for (size_t r = 0; r < numReplicas; ++r) {
+            costs[r] = collectCandidate(replicas[r], candidates[r]);
+        }
+
+        // The hottest replica accepts an average uphill move half of the time
+        if (!calibrated) {
+            double uphill = 0.0;
+            size_t count = 0;
+            for (size_t r = 0; r < numReplicas; ++r) {
+                if (costs[r] > replicas[r].cost && costs[r] < std::numeric_limits<float>::max()) {
+                    uphill += costs[r] - replicas[r].cost;
+                    count++;
+                }
+            }
+            if (count > 0) {
+                double maxTemp = uphill / count / std::log(2.0);
+                ladder.reset(maxTemp * kLadderSpan, maxTemp);
+                std::cout << "Temperature ladder: " << ladder.temperature(0) << " to " << maxTemp << " over " << numReplicas << " replicas" << std::endl;
+                calibrated = true;
+            }
+        }
+
+        for (size_t r = 0; r < numReplicas; ++r) {
+            double temp = ladder.temperature(r);
+            if (costs[r] < replicas[r].cost ||
+                std::exp((replicas[r].cost - costs[r]) / temp) > streams[r].uniform()) {
+                acceptCandidate(replicas[r], candidates[r], costs[r]);
+            }
+            updateBest(replicas[r].assignment, replicas[r].cost, budget);
+        }
+
+        // Metropolis exchange between neighboring temperatures, alternating even and odd pairs
+        if (config.swapInterval > 0 && step % config.swapInterval == 0) {
+            for (size_t i = exchangeRounds % 2; i + 1 < numReplicas; i += 2) {
+                double exponent = (1.0 / ladder.temperature(i) - 1.0 / ladder.temperature(i + 1)) *
+                                  (static_cast<double>(replicas[i].cost) - replicas[i + 1].cost);
+                bool accepted = exponent >= 0.0 || std::exp(exponent) > random.uniform();
+                if (accepted) {
+                    std::swap(replicas[i], replicas[i + 1]);
+                }
+                ladder.recordSwap(i, accepted);
+            }
+            exchangeRounds++;
+            if (calibrated && exchangeRounds % kLadderAdaptRounds == 0) {
+                ladder.adapt();
+            }
+        }
+
+        if (step % 100 == 0) {
+            std::cout << "Step " << step << ": Cold replica cost = " << replicas[0].cost << ", Best cost = " << bestCost
+                      << ", Temperatures " << ladder.temperature(0) << " to " << ladder.temperature(numReplicas - 1) << std::endl;
+            if (surrogate.ready()) {
+                std::cout << "Surrogate mean absolute error = " << surrogate.meanAbsoluteError() << std::endl;
+            }
+        }
+
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+    }
+
+    finishSearch(budget);
+}
+
+// Batch move engine: every round tests many single-gate moves at once with a designed experiment
+// and commits the ones whose estimated effect is an improvement
+void Optimizer::batchMoveSearch() {
+    SearchBudget budget = createBudget();
+    initializeSearch();
+    budget.improve(bestCost, estimatorPool.evaluations());
+
+    BatchMoveSearch search(cellTable, [this](const std::vector<CellAssignment>& batch) { return evaluateBatch(batch); },
+                           config.batchDesign == "random" ? BATCH_DESIGN_RANDOM : BATCH_DESIGN_HADAMARD, config.batchMoves);
+    auto nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+    int roundNumber = 0;
+    while (!exhausted(budget)) {
+        roundNumber++;
+        if (search.round(current.assignment, current.cost, random)) {
+            updateBest(current.assignment, current.cost, budget);
+        }
+
+        if (roundNumber % 10 == 0) {
+            std::cout << "Round " << roundNumber << ": Best cost = " << bestCost << ", " << search.committedMoves()
+                      << " moves committed in " << search.evaluations() << " evaluations" << std::endl;
+        }
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+    }
+
+    finishSearch(budget);
+}
+
+// Genetic engine: a population of assignments evolved with fanin-cone crossover, mutation and elitism
+void Optimizer::geneticSearch() {
+    SearchBudget budget = createBudget();
+    initializeSearch();
+    budget.improve(bestCost, estimatorPool.evaluations());
+
+    GeneticConfig geneticConfig;
+    geneticConfig.populationSize = config.populationSize;
+    geneticConfig.eliteCount = config.eliteCount;
+    geneticConfig.coneDepth = config.coneDepth;
+    GeneticSearch search(cellTable, graph, [this](const std::vector<CellAssignment>& batch) { return evaluateBatch(batch); },
+                         geneticConfig);
+    search.initialize(current.assignment, current.cost, random);
+
+    auto nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+    int generation = 0;
+    while (true) {
+        updateBest(search.best(), search.bestCost(), budget);
+        if (exhausted(budget)) {
+            break;
+        }
+
+        search.generation(random);
+        generation++;
+        if (generation % 10 == 0) {
+            std::cout << "Generation " << generation << ": Best cost = " << bestCost << ", Diversity = " << search.diversity()
+                      << ", Evaluations = " << search.evaluations() << std::endl;
+        }
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+    }
+
+    finishSearch(budget);
+}
+
+// Tabu engine: steepest descent over a sampled neighborhood that also takes worsening steps, with
+// recently undone moves forbidden so it does not cycle back
+void Optimizer::tabuSearch() {
+    SearchBudget budget = createBudget();
+    initializeSearch();
+    budget.improve(bestCost, estimatorPool.evaluations());
+
+    TabuSearch search(cellTable, mappingHasher, [this](const std::vector<CellAssignment>& batch) { return evaluateBatch(batch); },
+                      config.tabuNeighbors, config.tabuTenure);
+    search.reset(current.assignment);
+    auto nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+    int step = 0;
+    while (!exhausted(budget)) {
+        step++;
+        size_t evaluations = search.evaluations();
+        if (search.step(current.assignment, current.cost, bestCost, random)) {
+            updateBest(current.assignment, current.cost, budget);
+        } else if (search.evaluations() == evaluations) {
+            break;  // No gate has an alternative cell
+        }
+
+        if (step % 10 == 0) {
+            std::cout << "Step " << step << ": Current cost = " << current.cost << ", Best cost = " << bestCost
+                      << ", Tenure = " << search.tenure() << std::endl;
+        }
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+    }
+    std::cout << "Tabu search: " << search.evaluations() << " evaluations, " << search.aspirations() << " aspirations, "
+              << search.revisits() << " revisits, final tenure " << search.tenure() << std::endl;
+
+    finishSearch(budget);
+}
+
+// Cone-partitioned engine: the movable gates are split into loosely coupled output cones and every
+// partition gets its own annealing chain that only moves its gates, with the neighbors of all chains
+// evaluated side by side. The best partition results are then stitched together and the remaining
+// budget goes to a global tabu search refinement of the stitched mapping.
+void Optimizer::partitionedSearch() {
+    SearchBudget budget = createBudget();
+    initializeSearch();
+    budget.improve(bestCost, estimatorPool.evaluations());
+
+    ConePartitioner partitioner(cellTable, graph, config.partitions > 0 ? config.partitions : std::max<size_t>(estimatorPool.size(), 2));
+    const std::vector<std::vector<size_t>>& partitions = partitioner.partitions();
+    std::cout << "Partitions: " << partitioner.numCones() << " output cones in " << partitions.size() << " partitions of";
+    for (const auto& part : partitions) {
+        std::cout << " " << part.size();
+    }
+    std::cout << " movable gates, " << partitioner.cutEdges() << " connections cut" << std::endl;
+
+    // Every chain starts from the same mapping and differs from it only on its own partition
+    size_t numChains = partitions.size();
+    std::vector<SearchState> chains(numChains, current);
+    std::vector<SearchState> chainBest(numChains, current);
+    std::vector<Candidate> candidates(numChains);
+    std::vector<double> initialTemps(numChains, 0.0);  // Set by the first uphill move of each chain
+    std::vector<Random> streams;
+    for (size_t c = 0; c < numChains; ++c) {
+        streams.push_back(random.split());
+    }
+
+    int step = 0;
+    auto nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+    while (numChains > 0 && !exhausted(budget) &&
+           budget.progress(estimatorPool.evaluations()) < config.partitionShare) {
+        step++;
+        if (remeasureInterval() > 0 && step % remeasureInterval() == 0) {
+            for (size_t c = 0; c < numChains; ++c) {
+                remeasureCost(chains[c]);
+            }
+        }
+        for (size_t c = 0; c < numChains; ++c) {
+            candidates[c] = Candidate();
+            getScreenedNeighbor(chains[c], streams[c], candidates[c], &partitions[c]);
+            submitCandidate(chains[c], candidates[c]);
+        }
+        // Each chain cools geometrically over the partition phase from half acceptance of its first uphill move
+        double phase = budget.progress(estimatorPool.evaluations()) / config.partitionShare;
+        for (size_t c = 0; c < numChains; ++c) {
+            float cost = collectCandidate(chains[c], candidates[c]);
+            if (cost >= std::numeric_limits<float>::max()) {
+                continue;
+            }
+            if (cost > chains[c].cost && initialTemps[c] == 0.0) {
+                initialTemps[c] = (cost - chains[c].cost) / std::log(2.0);
+            }
+            double temp = initialTemps[c] * std::pow(kPartitionFinalTemp, phase);
+            if (cost < chains[c].cost || (temp > 0.0 && std::exp((chains[c].cost - cost) / temp) > streams[c].uniform())) {
+                acceptCandidate(chains[c], candidates[c], cost);
+                if (chains[c].cost < chainBest[c].cost) {
+                    chainBest[c] = chains[c];
+                }
+                updateBest(chains[c].assignment, chains[c].cost, budget);
+            }
+        }
+
+        if (step % 100 == 0) {
+            std::cout << "Partition step " << step << ": Best cost = " << bestCost << ", partition best costs =";
+            for (size_t c = 0; c < numChains; ++c) {
+                std::cout << " " << chainBest[c].cost;
+            }
+            std::cout << std::endl;
+        }
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+    }
+
+    // Stitch the partitions in order of their results, keeping each one only if the joint mapping gets
+    // cheaper; the first one reproduces its chain's best mapping, which the cache already knows
+    std::vector<size_t> stitchOrder(numChains);
+    for (size_t c = 0; c < numChains; ++c) {
+        stitchOrder[c] = c;
+    }
+    std::stable_sort(stitchOrder.begin(), stitchOrder.end(), [&](size_t a, size_t b) { return chainBest[a].cost < chainBest[b].cost; });
+    CellAssignment stitched = current.assignment;
+    float stitchedCost = current.cost;
+    size_t stitchedParts = 0;
+    for (size_t c : stitchOrder) {
+        if (chainBest[c].cost >= current.cost || exhausted(budget)) {
+            continue;
+        }
+        CellAssignment trial = stitched;
+        for (size_t gate : partitions[c]) {
+            trial.set(gate, chainBest[c].assignment[gate]);
+        }
+        float cost = calculateCost(trial);
+        if (cost < stitchedCost) {
+            stitched = trial;
+            stitchedCost = cost;
+            stitchedParts++;
+        }
+    }
+    std::cout << "Stitched " << stitchedParts << " of " << numChains << " partitions: cost " << current.cost << " -> "
+              << stitchedCost << " after " << step << " partition steps" << std::endl;
+    updateBest(stitched, stitchedCost, budget);
+
+    // Global refinement from the best mapping found so far
+    current.assignment = bestAssignment;
+    current.cost = bestCost;
+    TabuSearch refinement(cellTable, mappingHasher, [this](const std::vector<CellAssignment>& batch) { return evaluateBatch(batch); },
+                          config.tabuNeighbors, config.tabuTenure);
+    refinement.reset(current.assignment);
+    int refinementStep = 0;
+    while (!exhausted(budget)) {
+        refinementStep++;
+        size_t evaluations = refinement.evaluations();
+        if (refinement.step(current.assignment, current.cost, bestCost, random)) {
+            updateBest(current.assignment, current.cost, budget);
+        } else if (refinement.evaluations() == evaluations) {
+            break;
+        }
+        if (refinementStep % 10 == 0) {
+            std::cout << "Refinement step " << refinementStep << ": Current cost = " << current.cost << ", Best cost = " << bestCost << std::endl;
+        }
+        if (!config.metricsFile.empty() && std::chrono::steady_clock::now() >= nextMetricsTime) {
+            writeMetrics();
+            nextMetricsTime = std::chrono::steady_clock::now() + std::chrono::seconds(config.metricsInterval);
+        }
+    }
+
+    finishSearch(budget);
+}
+
+// Function to write the evaluation latency report together with the cache statistics
+void Optimizer::writeMetrics() {
+    EvaluationMetrics& metrics = estimatorPool.metrics();
+    metrics.setCounter("cache_hits", static_cast<double>(costCache.hits()));
+    metrics.setCounter("cache_misses", static_cast<double>(costCache.misses()));
+    metrics.setCounter("workers", static_cast<double>(estimatorPool.size()));
+    metrics.writeJson(config.metricsFile, costEstimator);
 }
 
 // Function to update the cost_output.txt file with the best cost
@@ -152,70 +1232,59 @@ float Optimizer::optimize() {
     std::streambuf* coutbuf = std::cout.rdbuf(); // Save old buf
     std::cout.rdbuf(outFile.rdbuf()); // Redirect cout to optimizer.txt
 
-    simulatedAnnealing();
+    if (config.engine == "pt") {
+        parallelTempering();
+    } else if (config.engine == "batch") {
+        batchMoveSearch();
+    } else if (config.engine == "ga") {
+        geneticSearch();
+    } else if (config.engine == "tabu") {
+        tabuSearch();
+    } else if (config.engine == "cone") {
+        partitionedSearch();
+    } else {
+        simulatedAnnealing();
+    }
 
     // Restore cout back to standard output
     std::cout.rdbuf(coutbuf);
 
-    // Write the best solution to the output file
-    NetlistWriter netlistWriter;
-    netlistWriter.writeNetlist(netlist, gateToCellMapping, outputFile);
+    // Write the best solution to the output file, unless a rejected checkpoint left no mapping to write
+    if (!checkpointFailed) {
+        NetlistWriter netlistWriter;
+        netlistWriter.writeNetlist(netlist, cellTable.names(), current.assignment.cells(), outputFile);
+    }
 
-    float finalCost = calculateCost(gateToCellMapping);
-    return finalCost;
+    return current.cost;
 }
 
-float Optimizer::runCostEstimator() {
-    std::string command = costEstimator + " -library " + cellLibraryFile + " -netlist " + outputFile + " -output temp_cost_output.txt 2>> optimizer.txt";
-    std::cout << "Running command: " << command << std::endl;
-    system(command.c_str());
-
-    std::ifstream costFile("temp_cost_output.txt");
-    float cost = std::numeric_limits<float>::max();
-    if (costFile.is_open()) {
-        std::string line;
-        std::getline(costFile, line);
-        try {
-            size_t pos = line.find('=');
-            if (pos != std::string::npos) {
-                cost = std::stof(line.substr(pos + 1));
-            } else {
-                std::cerr << "Error: Could not find '=' in cost output." << std::endl;
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "Exception parsing cost: " << e.what() << std::endl;
-        }
-        costFile.close();
-    } else {
-        std::cerr << "Error: Could not open cost file." << std::endl;
-    }
-
-    return cost;
+bool Optimizer::failed() const {
+    return estimatorPool.failed() || checkpointFailed;
 }
 
 void Optimizer::adjustNetlist() {
     std::cout << "Adjusting netlist:" << std::endl;
 
-    for (auto& gate : netlist.gates) {
+    for (size_t i = 0; i < netlist.gates.size(); ++i) {
+        const auto& gate = netlist.gates[i];
         std::cout << "Processing gate " << gate.name << " of type " << gate.type << std::endl;
 
         // Collect possible cells of the same type
-        auto it = gateMapping.find(gate.type);
-        if (it != gateMapping.end() && !it->second.empty()) {
-            const std::vector<std::string>& possibleCells = it->second;
-
+        const std::vector<uint16_t>& possibleCells = cellTable.candidates(i);
+        if (!possibleCells.empty()) {
             if (possibleCells.size() > 1) {
-                std::string currentCell = gateToCellMapping[gate.name];
-                std::string newCell;
+                uint16_t currentCell = current.assignment[i];
+                uint16_t newCell;
                 size_t attempts = 0;
                 do {
-                    newCell = possibleCells[std::rand() % possibleCells.size()];
+                    newCell = possibleCells[random.below(possibleCells.size())];
                     attempts++;
                 } while (newCell == currentCell && attempts < possibleCells.size());
 
                 if (newCell != currentCell) {
-                    std::cout << "Changing gate " << gate.name << " of type " << gate.type << " from " << currentCell << " to " << newCell << std::endl;
-                    gateToCellMapping[gate.name] = newCell;
+                    std::cout << "Changing gate " << gate.name << " of type " << gate.type << " from "
+                              << (currentCell != kNoCell ? cellTable.name(currentCell) : "(none)") << " to " << cellTable.name(newCell) << std::endl;
+                    current.assignment.set(i, newCell);
                 } else {
                     std::cout << "No different cell found for gate type " << gate.type << " after " << attempts << " attempts." << std::endl;
                 }
@@ -2,30 +2,179 @@
 #define OPTIMIZER_HPP
 
 #include "NetlistParser.hpp"
+#include "CellAssignment.hpp"
+#include "EstimatorPool.hpp"
+#include "CostCache.hpp"
+#include "SurrogateModel.hpp"
+#include "EstimatorProbe.hpp"
+#include "CellLibraryParser.hpp"
+#include "Random.hpp"
+#include "NetlistGraph.hpp"
+#include "MoveOperators.hpp"
+#include "OperatorBandit.hpp"
+#include "SearchBudget.hpp"
+#include "CoolingSchedule.hpp"
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
+struct OptimizerConfig {
+    size_t numWorkers = 1;          // Number of concurrent cost estimator workers
+    std::string scratchDir;         // Per-worker scratch space, defaults to <output>.work
+    size_t pipelineDepth = 0;       // Speculative neighbors kept in flight, 0 means one per worker
+    int revalidateInterval = 0;     // Re-measure the current mapping every N iterations, 0 disables it
+    size_t cacheCapacity = 100000;  // Costs kept in the in-memory LRU cache, 0 disables it
+    std::string cacheDir;           // Directory of the persistent cost cache, empty disables it
+    size_t diskCacheCapacity = 1000000;  // Slots of the in-memory index of the persistent cost cache
+    std::string metricsFile;        // JSON evaluation latency report, empty disables it
+    int metricsInterval = 60;       // Seconds between metrics reports during the run
+    size_t surrogateScreen = 0;     // Neighbors screened by the surrogate model per evaluation, 0 or 1 disables it
+    size_t surrogateRefit = 50;     // New samples between surrogate refits
+    size_t probePairs = 0;          // Pair perturbations used to probe the estimator's cost structure, 0 disables probing
+    std::string engine = "sa";      // Search engine: sa (simulated annealing), pt (parallel tempering), batch (group testing), ga (genetic), tabu or cone (partitioned)
+    size_t replicas = 0;            // Parallel tempering replicas, 0 means one per worker but at least 4
+    int swapInterval = 10;          // Parallel tempering steps between replica exchange rounds
+    uint64_t seed = 0;              // Random seed, 0 picks one from the clock
+    double timeLimit = 0.0;         // Wall-clock limit in seconds, 0 derives it from the gate count
+    size_t maxEvaluations = 0;      // Estimator evaluation limit, 0 means unlimited
+    size_t stallEvaluations = 0;    // Stop after this many evaluations without improvement, 0 disables it
+    double stallEpsilon = 0.0;      // Relative best-cost improvement that counts as progress
+    std::string initialization = "first";  // Starting mapping: first (first listed cell) or sweep (GreedySweep)
+    size_t sweepRounds = 3;         // Coordinate descent rounds of the sweep initialization
+    size_t batchMoves = 63;         // Moves tested together per batch engine round
+    std::string batchDesign = "hadamard";  // Batch engine experiment: hadamard or random
+    size_t populationSize = 32;     // Genetic engine population, evaluated as one batch per generation
+    size_t eliteCount = 2;          // Genetic engine individuals kept unchanged per generation
+    size_t coneDepth = 4;           // Levels of the fanin cones exchanged by genetic crossover
+    size_t tabuNeighbors = 16;      // Tabu engine neighbors evaluated as one batch per step
+    size_t tabuTenure = 0;          // Initial tabu tenure in steps, 0 derives it from the gate count
+    size_t partitions = 0;          // Cone engine partitions, 0 means one per worker but at least 2
+    double partitionShare = 0.5;    // Share of the budget spent on the partitions before the global refinement
+    std::string cooling = "adaptive";  // Annealing schedule: adaptive (calibrated, modified Lam) or fixed (from 1000 by alpha)
+    double initialAcceptance = 0.8;  // Acceptance probability of an average uphill move at the calibrated start
+    std::string checkpointFile;     // Annealer checkpoint, empty disables checkpointing
+    int checkpointInterval = 300;   // Seconds between checkpoints
+    bool resume = false;            // Continue from checkpointFile if it exists
+    std::string movePolicy = "single";  // Neighbor moves: single (one gate) or ucb/thompson (bandit over move operators)
+    int delayAttribute = -1;        // Cell attribute the critical-path operator takes as delay; -1 uses the mock
+                                    // estimator's delay_attr, or unit gate delays for an external estimator
+    std::string cellPruning = "off";  // Library pruning: off, pareto (drop dominated cells) or strict (keep those the estimator prefers)
+};
+
+// A point of the search space with its cost, hash and surrogate features
+struct SearchState {
+    CellAssignment assignment;
+    float cost = std::numeric_limits<float>::max();
+    MappingKey key;
+    std::vector<double> features;  // Empty unless surrogate screening is enabled
+};
+
 class Optimizer {
 public:
     Optimizer(const Netlist& netlist, const std::unordered_map<std::string, std::vector<std::string>>& gateMapping,
-              const std::string& cellLibraryFile, const std::string& outputFile, const std::string& costEstimator);
+              const std::vector<Cell>& cells, const std::string& cellLibraryFile, const std::string& outputFile, const std::string& costEstimator,
+              const OptimizerConfig& config = OptimizerConfig());
 
     float optimize();
+    // True if the run stopped because the cost estimator could not be started or the checkpoint to
+    // resume could not be used
+    bool failed() const;
 
 private:
     const Netlist& netlist;
-    std::unordered_map<std::string, std::vector<std::string>> gateMapping;
-    std::unordered_map<std::string, std::string> gateToCellMapping;
+    CellTable cellTable;
+    NetlistGraph graph;
+    SearchState current;  // Cost is refreshed only when a move is accepted, the hash is maintained per move
+    CellAssignment bestAssignment;
+    float bestCost;
+    uint64_t seed;
+    Random random;  // Main stream; the probe and every parallel chain split off their own
     std::string cellLibraryFile;
     std::string outputFile;
     std::string costEstimator;
+    OptimizerConfig config;
+    EstimatorPool estimatorPool;
+    MappingHasher mappingHasher;
+    CostCache costCache;
+    SurrogateModel surrogate;
+    std::vector<std::unique_ptr<MoveOperator>> moveOperators;  // Empty unless a bandit schedules the moves
+    std::unique_ptr<OperatorBandit> operatorBandit;
+
+    // Moves on distinct gates away from the current assignment with the incrementally maintained hash
+    // and surrogate features. The neighbor assignment itself is only materialized for the estimator.
+    struct Candidate {
+        std::vector<CellMove> moves;  // Empty if no alternative cell was found and the neighbor equals current
+        int moveOperator = -1;        // Operator that proposed the moves, -1 without the bandit scheduler
+        MappingKey key;
+        std::vector<double> features;
+        bool cached;
+        float cachedCost;
+        std::future<float> cost;
+    };
+
+    // Annealer state a checkpoint carries besides the optimizer's own
+    struct AnnealingState {
+        float temperature = 1000.0f;
+        float alpha = 0.95f;
+        int iteration = 0;
+        int resetCounter = 0;
+        CoolingSchedule cooling{0.8, 0};
+        std::vector<std::vector<CellMove>> pendingMoves;  // Speculative neighbors in flight, oldest first
+        std::vector<int> pendingOperators;
+    };
 
-    float runCostEstimator();
     void adjustNetlist();
     void updateCostFile(float bestCost);
-    void getNeighbor(std::unordered_map<std::string, std::string>& neighborMapping);
-    float calculateCost(const std::unordered_map<std::string, std::string>& mapping);
+    // Exact delta evaluation, enabled when probing shows the cost is additive over gates. Deltas are
+    // cost changes relative to the probed base mapping and are learned from every evaluated move.
+    bool exactDelta = false;
+    bool positionIndependent = false;
+    CellAssignment deltaBase;
+    std::vector<std::unordered_map<uint16_t, float>> gateDeltas;
+    std::unordered_map<uint32_t, float> cellDeltas;  // Keyed by (base cell << 16) | cell
+
+    void probeCostStructure();
+    int remeasureInterval() const;
+    void remeasureCost(SearchState& state);
+    bool lookupDelta(size_t gate, uint16_t cell, float& delta) const;
+    void learnDelta(size_t gate, uint16_t cell, float delta);
+
+    // Restricting the neighbor to a set of gates bypasses the move operators and uses single moves
+    void getNeighbor(const SearchState& from, Random& rng, Candidate& neighbor, const std::vector<size_t>* gates = nullptr);
+    void getScreenedNeighbor(const SearchState& from, Random& rng, Candidate& neighbor, const std::vector<size_t>* gates = nullptr);
+    // Derive the hash and surrogate features of a candidate whose moves are set
+    void completeCandidate(const SearchState& from, Candidate& neighbor);
+    // Resolve a candidate from the cache or known deltas, or queue it on the estimator pool
+    void submitCandidate(SearchState& from, Candidate& candidate);
+    // Wait for a submitted candidate's cost and feed it to the cache, surrogate and delta tables
+    float collectCandidate(const SearchState& from, Candidate& candidate);
+    void acceptCandidate(SearchState& state, Candidate& candidate, float cost);
+    float calculateCost(const CellAssignment& assignment);
+    // Costs of several assignments through the cache, with the misses evaluated concurrently
+    size_t remainingEvaluations() const;
+    std::vector<float> evaluateBatch(const std::vector<CellAssignment>& assignments);
+    SearchBudget createBudget() const;
+    void pruneCells();
+    void initializeSearch();
+    void setUpMoveOperators();
+    void saveCheckpoint(const SearchBudget& budget, const AnnealingState& state);
+    // Restore the state saved by saveCheckpoint; returns false with an error when the checkpoint cannot
+    // be read or does not belong to this run, leaving the optimizer to be discarded
+    bool loadCheckpoint(SearchBudget& budget, AnnealingState& state);
+    bool checkpointFailed = false;
+    void updateBest(const CellAssignment& assignment, float cost, SearchBudget& budget);
+    void finishSearch(const SearchBudget& budget);
+    bool exhausted(SearchBudget& budget);
     void simulatedAnnealing();
+    void parallelTempering();
+    void batchMoveSearch();
+    void geneticSearch();
+    void tabuSearch();
+    void partitionedSearch();
+    void writeMetrics();
 };
 
 #endif // OPTIMIZER_HPP
@@ -0,0 +1,58 @@
+#include "ParetoPruner.hpp"
+
+static std::vector<double> attributes(const Cell& cell) {
+    std::vector<double> values(cell.float_data.begin(), cell.float_data.end());
+    values.insert(values.end(), cell.int_data.begin(), cell.int_data.end());
+    return values;
+}
+
+ParetoPruner::ParetoPruner(const CellTable& cellTable) : cellTable(cellTable), frontDominator(cellTable.numCells(), kNoCell) {
+    for (size_t t = 1; t < cellTable.numTypes(); ++t) {
+        const std::vector<uint16_t>& cells = cellTable.typeCells(t);
+        std::vector<uint16_t> onFront;
+        for (uint16_t b : cells) {
+            bool dominated = false;
+            for (uint16_t a : cells) {
+                if (a != b && dominates(a, b)) {
+                    dominated = true;
+                    break;
+                }
+            }
+            if (!dominated) {
+                onFront.push_back(b);
+            }
+        }
+        // Dominance is transitive, so every dominated cell is dominated by some front cell
+        for (uint16_t b : cells) {
+            for (uint16_t a : onFront) {
+                if (a != b && dominates(a, b)) {
+                    frontDominator[b] = a;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool ParetoPruner::dominates(uint16_t a, uint16_t b) const {
+    std::vector<double> x = attributes(cellTable.cell(a));
+    std::vector<double> y = attributes(cellTable.cell(b));
+    if (x.size() != y.size()) {
+        return false;
+    }
+    bool better = false;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (x[i] > y[i]) {
+            return false;
+        }
+        if (x[i] < y[i]) {
+            better = true;
+        }
+    }
+    // Identical cells: the one listed first in the library stands for the others
+    return better || a < b;
+}
+
+uint16_t ParetoPruner::dominator(uint16_t cell) const {
+    return frontDominator[cell];
+}
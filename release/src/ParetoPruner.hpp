@@ -0,0 +1,25 @@
+#ifndef PARETO_PRUNER_HPP
+#define PARETO_PRUNER_HPP
+
+#include "CellAssignment.hpp"
+#include <vector>
+
+// Pareto analysis of the library per gate type. A cell is dominated when another cell of its type is
+// no larger on every float_data/int_data attribute and smaller on at least one; of several identical
+// cells only the first is kept. Pruning dominated cells is exact whenever the cost never decreases as
+// an attribute grows.
+class ParetoPruner {
+public:
+    explicit ParetoPruner(const CellTable& cellTable);
+
+    // A front cell dominating the cell, or kNoCell when the cell is on the front itself
+    uint16_t dominator(uint16_t cell) const;
+
+private:
+    const CellTable& cellTable;
+    std::vector<uint16_t> frontDominator;  // Indexed by cell id
+
+    bool dominates(uint16_t a, uint16_t b) const;
+};
+
+#endif // PARETO_PRUNER_HPP
@@ -0,0 +1,93 @@
+#include "Random.hpp"
+#include <chrono>
+
+static uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+Random::Random(uint64_t seed) {
+    this->seed(seed);
+}
+
+void Random::seed(uint64_t seed) {
+    // splitmix64 expands the seed so that no state word starts at zero for small seeds
+    for (int i = 0; i < 4; ++i) {
+        state[i] = splitmix64(seed);
+    }
+}
+
+uint64_t Random::next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+size_t Random::below(size_t bound) {
+    // Reject the incomplete last block of the 64-bit range so every value is equally likely
+    uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+    uint64_t value;
+    do {
+        value = next();
+    } while (value >= limit);
+    return static_cast<size_t>(value % bound);
+}
+
+double Random::uniform() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+Random Random::split() {
+    Random stream = *this;
+    jump();
+    return stream;
+}
+
+void Random::jump() {
+    static const uint64_t kJump[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 64; ++b) {
+            if (kJump[i] & (1ULL << b)) {
+                for (int w = 0; w < 4; ++w) {
+                    s[w] ^= state[w];
+                }
+            }
+            next();
+        }
+    }
+    for (int w = 0; w < 4; ++w) {
+        state[w] = s[w];
+    }
+}
+
+uint64_t Random::timeSeed() {
+    return static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+}
+
+void Random::save(CheckpointWriter& out) const {
+    for (uint64_t word : state) {
+        out.put(word);
+    }
+}
+
+bool Random::load(CheckpointReader& in) {
+    for (uint64_t& word : state) {
+        if (!in.get(word)) {
+            return false;
+        }
+    }
+    return true;
+}
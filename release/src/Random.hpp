@@ -0,0 +1,37 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include "Checkpoint.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// xoshiro256** generator. Every optimizer and every parallel chain owns one, so runs replay exactly
+// from their seed and threads never share generator state. Independent substreams are split off with
+// the generator's jump function, which advances it by 2^128 draws.
+class Random {
+public:
+    explicit Random(uint64_t seed = 0);
+
+    void seed(uint64_t seed);
+    uint64_t next();
+    // Uniform integer in [0, bound), bound > 0
+    size_t below(size_t bound);
+    // Uniform double in [0, 1)
+    double uniform();
+
+    // Return a generator for the next 2^128 draws and skip this one past them
+    Random split();
+
+    void save(CheckpointWriter& out) const;
+    bool load(CheckpointReader& in);
+
+    // Seed derived from the clock for runs without an explicit seed
+    static uint64_t timeSeed();
+
+private:
+    uint64_t state[4];
+
+    void jump();
+};
+
+#endif // RANDOM_HPP
@@ -0,0 +1,476 @@
+#include "SatSolver.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const uint8_t kUnassigned = 2;
+static const double kVarDecay = 0.95;
+static const double kClauseDecay = 0.999;
+static const size_t kRestartBase = 100;  // Conflicts of the first restart interval, scaled by the Luby sequence
+static const size_t kInitialMaxLearnts = 4000;
+
+// Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, ...
+static size_t luby(size_t index) {
+    size_t size = 1;
+    size_t sequence = 0;
+    while (size < index + 1) {
+        sequence++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) >> 1;
+        sequence--;
+        index = index % size;
+    }
+    return static_cast<size_t>(1) << sequence;
+}
+
+const uint32_t SatSolver::kNoReason;
+
+SatSolver::SatSolver()
+    : ok(true), head(0), varIncrement(1.0), clauseIncrement(1.0), learntCount(0), maxLearnts(kInitialMaxLearnts), conflictCount(0) {}
+
+int SatSolver::newVar() {
+    int var = static_cast<int>(assigns.size());
+    assigns.push_back(kUnassigned);
+    levels.push_back(0);
+    reasons.push_back(kNoReason);
+    polarity.push_back(1);
+    seen.push_back(0);
+    decisions.push_back(1);
+    activity.push_back(0.0);
+    heapIndex.push_back(-1);
+    watches.resize(2 * assigns.size());
+    heapInsert(var);
+    return var;
+}
+
+size_t SatSolver::numVars() const {
+    return assigns.size();
+}
+
+void SatSolver::setDecision(int var, bool decision) {
+    decisions[var] = decision ? 1 : 0;
+    if (decision && assigns[var] == kUnassigned && heapIndex[var] < 0) {
+        heapInsert(var);
+    }
+}
+
+size_t SatSolver::conflicts() const {
+    return conflictCount;
+}
+
+int SatSolver::value(int literal) const {
+    uint8_t assign = assigns[literal >> 1];
+    return assign == kUnassigned ? kUnassigned : assign ^ (literal & 1);
+}
+
+size_t SatSolver::decisionLevel() const {
+    return trailLimits.size();
+}
+
+bool SatSolver::modelValue(int var) const {
+    return static_cast<size_t>(var) < model.size() && model[var] == 1;
+}
+
+void SatSolver::enqueue(int literal, uint32_t reason) {
+    int var = literal >> 1;
+    assigns[var] = (literal & 1) ? 0 : 1;
+    levels[var] = static_cast<int>(decisionLevel());
+    reasons[var] = reason;
+    trail.push_back(literal);
+}
+
+uint32_t SatSolver::attachClause(const std::vector<int>& literals, bool learnt) {
+    uint32_t index;
+    if (!freeClauses.empty()) {
+        index = freeClauses.back();
+        freeClauses.pop_back();
+    } else {
+        index = static_cast<uint32_t>(clauses.size());
+        clauses.emplace_back();
+    }
+    Clause& clause = clauses[index];
+    clause.literals = literals;
+    clause.learnt = learnt;
+    clause.deleted = false;
+    clause.activity = 0.0;
+    watches[literals[0]].push_back(Watcher{index, literals[1]});
+    watches[literals[1]].push_back(Watcher{index, literals[0]});
+    if (learnt) {
+        learntCount++;
+    }
+    return index;
+}
+
+bool SatSolver::addClause(std::vector<int> literals) {
+    if (!ok) {
+        return false;
+    }
+    cancelUntil(0);
+    std::sort(literals.begin(), literals.end());
+    size_t kept = 0;
+    for (size_t k = 0; k < literals.size(); ++k) {
+        int literal = literals[k];
+        if (value(literal) == 1 || (kept > 0 && literals[kept - 1] == (literal ^ 1))) {
+            return true;  // Satisfied at level 0 or a tautology
+        }
+        if (value(literal) == 0 || (kept > 0 && literals[kept - 1] == literal)) {
+            continue;
+        }
+        literals[kept++] = literal;
+    }
+    literals.resize(kept);
+    if (literals.empty()) {
+        ok = false;
+    } else if (literals.size() == 1) {
+        enqueue(literals[0], kNoReason);
+        ok = propagate() == kNoReason;
+    } else {
+        attachClause(literals, false);
+    }
+    return ok;
+}
+
+uint32_t SatSolver::propagate() {
+    uint32_t conflict = kNoReason;
+    while (head < trail.size()) {
+        int falseLiteral = trail[head++] ^ 1;
+        std::vector<Watcher>& list = watches[falseLiteral];
+        size_t i = 0;
+        size_t j = 0;
+        while (i < list.size()) {
+            Watcher watcher = list[i++];
+            if (value(watcher.blocker) == 1) {
+                list[j++] = watcher;
+                continue;
+            }
+            std::vector<int>& literals = clauses[watcher.clause].literals;
+            if (literals[0] == falseLiteral) {
+                std::swap(literals[0], literals[1]);
+            }
+            int first = literals[0];
+            if (first != watcher.blocker && value(first) == 1) {
+                list[j++] = Watcher{watcher.clause, first};
+                continue;
+            }
+            // Look for a literal that is not false to watch instead
+            bool moved = false;
+            for (size_t k = 2; k < literals.size(); ++k) {
+                if (value(literals[k]) != 0) {
+                    literals[1] = literals[k];
+                    literals[k] = falseLiteral;
+                    watches[literals[1]].push_back(Watcher{watcher.clause, first});
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+            list[j++] = Watcher{watcher.clause, first};
+            if (value(first) == 0) {
+                conflict = watcher.clause;
+                head = trail.size();
+                while (i < list.size()) {
+                    list[j++] = list[i++];
+                }
+            } else {
+                enqueue(first, watcher.clause);
+            }
+        }
+        list.resize(j);
+    }
+    return conflict;
+}
+
+void SatSolver::analyze(uint32_t conflict, std::vector<int>& learnt, size_t& backtrackLevel) {
+    learnt.assign(1, 0);
+    int pathCount = 0;
+    int literal = -1;
+    size_t index = trail.size();
+    uint32_t reason = conflict;
+    do {
+        Clause& clause = clauses[reason];
+        if (clause.learnt) {
+            bumpClause(clause);
+        }
+        for (size_t k = literal == -1 ? 0 : 1; k < clause.literals.size(); ++k) {
+            int other = clause.literals[k];
+            int var = other >> 1;
+            if (!seen[var] && levels[var] > 0) {
+                bumpVariable(var);
+                seen[var] = 1;
+                if (static_cast<size_t>(levels[var]) >= decisionLevel()) {
+                    pathCount++;
+                } else {
+                    learnt.push_back(other);
+                }
+            }
+        }
+        // The next literal of the current level on the trail that takes part in the conflict
+        while (!seen[trail[--index] >> 1]) {
+        }
+        literal = trail[index];
+        reason = reasons[literal >> 1];
+        seen[literal >> 1] = 0;
+        pathCount--;
+    } while (pathCount > 0);
+    learnt[0] = literal ^ 1;
+
+    // Drop literals implied by the others through their reason clauses
+    std::vector<int> analyzed(learnt.begin() + 1, learnt.end());
+    size_t kept = 1;
+    for (size_t k = 1; k < learnt.size(); ++k) {
+        uint32_t implied = reasons[learnt[k] >> 1];
+        bool redundant = implied != kNoReason;
+        if (redundant) {
+            const std::vector<int>& literals = clauses[implied].literals;
+            for (size_t r = 1; r < literals.size(); ++r) {
+                int var = literals[r] >> 1;
+                if (!seen[var] && levels[var] > 0) {
+                    redundant = false;
+                    break;
+                }
+            }
+        }
+        if (!redundant) {
+            learnt[kept++] = learnt[k];
+        }
+    }
+    learnt.resize(kept);
+    for (int other : analyzed) {
+        seen[other >> 1] = 0;
+    }
+
+    backtrackLevel = 0;
+    if (learnt.size() > 1) {
+        size_t highest = 1;
+        for (size_t k = 2; k < learnt.size(); ++k) {
+            if (levels[learnt[k] >> 1] > levels[learnt[highest] >> 1]) {
+                highest = k;
+            }
+        }
+        std::swap(learnt[1], learnt[highest]);
+        backtrackLevel = static_cast<size_t>(levels[learnt[1] >> 1]);
+    }
+}
+
+void SatSolver::cancelUntil(size_t level) {
+    if (decisionLevel() <= level) {
+        return;
+    }
+    for (size_t k = trail.size(); k-- > trailLimits[level];) {
+        int var = trail[k] >> 1;
+        polarity[var] = trail[k] & 1;
+        assigns[var] = kUnassigned;
+        reasons[var] = kNoReason;
+        if (heapIndex[var] < 0 && decisions[var]) {
+            heapInsert(var);
+        }
+    }
+    trail.resize(trailLimits[level]);
+    trailLimits.resize(level);
+    head = trail.size();
+}
+
+int SatSolver::pickBranch() {
+    while (!heap.empty()) {
+        int var = heapPop();
+        if (assigns[var] == kUnassigned && decisions[var]) {
+            return 2 * var + polarity[var];
+        }
+    }
+    return -1;
+}
+
+int SatSolver::search(const std::vector<int>& assumptions, size_t restartConflicts, size_t conflictEnd) {
+    size_t conflictsHere = 0;
+    std::vector<int> learnt;
+    for (;;) {
+        uint32_t conflict = propagate();
+        if (conflict != kNoReason) {
+            conflictCount++;
+            conflictsHere++;
+            if (decisionLevel() == 0) {
+                ok = false;
+                return 0;
+            }
+            size_t backtrackLevel;
+            analyze(conflict, learnt, backtrackLevel);
+            cancelUntil(backtrackLevel);
+            if (learnt.size() == 1) {
+                enqueue(learnt[0], kNoReason);
+            } else {
+                uint32_t index = attachClause(learnt, true);
+                bumpClause(clauses[index]);
+                enqueue(learnt[0], index);
+            }
+            varIncrement /= kVarDecay;
+            clauseIncrement /= kClauseDecay;
+            continue;
+        }
+
+        if (conflictsHere >= restartConflicts || (conflictEnd != 0 && conflictCount >= conflictEnd)) {
+            cancelUntil(0);
+            return conflictEnd != 0 && conflictCount >= conflictEnd ? -2 : -1;
+        }
+        if (learntCount >= maxLearnts + trail.size()) {
+            reduceLearnts();
+        }
+
+        int next = -1;
+        while (decisionLevel() < assumptions.size()) {
+            int assumption = assumptions[decisionLevel()];
+            if (value(assumption) == 1) {
+                trailLimits.push_back(trail.size());  // Already holds: an empty decision level keeps the numbering
+            } else if (value(assumption) == 0) {
+                cancelUntil(0);
+                return 0;
+            } else {
+                next = assumption;
+                break;
+            }
+        }
+        if (next == -1) {
+            next = pickBranch();
+            if (next == -1) {
+                model = assigns;
+                cancelUntil(0);
+                return 1;
+            }
+        }
+        trailLimits.push_back(trail.size());
+        enqueue(next, kNoReason);
+    }
+}
+
+SatResult SatSolver::solve(const std::vector<int>& assumptions, size_t conflictLimit) {
+    model.clear();
+    if (!ok) {
+        return SAT_UNSATISFIABLE;
+    }
+    size_t conflictEnd = conflictLimit != 0 ? conflictCount + conflictLimit : 0;
+    for (size_t restart = 0;; ++restart) {
+        int status = search(assumptions, luby(restart) * kRestartBase, conflictEnd);
+        if (status == 1) {
+            return SAT_SATISFIABLE;
+        }
+        if (status == 0) {
+            return SAT_UNSATISFIABLE;
+        }
+        if (status == -2) {
+            return SAT_UNDECIDED;
+        }
+    }
+}
+
+void SatSolver::reduceLearnts() {
+    // Delete the less active half of the learnt clauses that are not binary and not reasons
+    std::vector<uint32_t> candidates;
+    for (uint32_t index = 0; index < clauses.size(); ++index) {
+        const Clause& clause = clauses[index];
+        if (!clause.learnt || clause.deleted || clause.literals.size() <= 2) {
+            continue;
+        }
+        int first = clause.literals[0];
+        if (value(first) == 1 && reasons[first >> 1] == index) {
+            continue;
+        }
+        candidates.push_back(index);
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+        return clauses[a].activity < clauses[b].activity;
+    });
+    for (size_t k = 0; k < candidates.size() / 2; ++k) {
+        Clause& clause = clauses[candidates[k]];
+        clause.deleted = true;
+        std::vector<int>().swap(clause.literals);
+        learntCount--;
+    }
+    for (auto& list : watches) {
+        list.erase(std::remove_if(list.begin(), list.end(), [&](const Watcher& watcher) { return clauses[watcher.clause].deleted; }),
+                   list.end());
+    }
+    for (size_t k = 0; k < candidates.size() / 2; ++k) {
+        freeClauses.push_back(candidates[k]);
+    }
+    maxLearnts += maxLearnts / 10;
+}
+
+void SatSolver::bumpVariable(int var) {
+    activity[var] += varIncrement;
+    if (activity[var] > 1e100) {
+        for (auto& a : activity) {
+            a *= 1e-100;
+        }
+        varIncrement *= 1e-100;
+    }
+    if (heapIndex[var] >= 0) {
+        heapUp(static_cast<size_t>(heapIndex[var]));
+    }
+}
+
+void SatSolver::bumpClause(Clause& clause) {
+    clause.activity += clauseIncrement;
+    if (clause.activity > 1e20) {
+        for (auto& other : clauses) {
+            other.activity *= 1e-20;
+        }
+        clauseIncrement *= 1e-20;
+    }
+}
+
+void SatSolver::heapInsert(int var) {
+    heapIndex[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    heapUp(heap.size() - 1);
+}
+
+int SatSolver::heapPop() {
+    int top = heap[0];
+    heapIndex[top] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        heapIndex[last] = 0;
+        heapDown(0);
+    }
+    return top;
+}
+
+void SatSolver::heapUp(size_t position) {
+    int var = heap[position];
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (activity[heap[parent]] >= activity[var]) {
+            break;
+        }
+        heap[position] = heap[parent];
+        heapIndex[heap[position]] = static_cast<int>(position);
+        position = parent;
+    }
+    heap[position] = var;
+    heapIndex[var] = static_cast<int>(position);
+}
+
+void SatSolver::heapDown(size_t position) {
+    int var = heap[position];
+    for (;;) {
+        size_t child = 2 * position + 1;
+        if (child >= heap.size()) {
+            break;
+        }
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) {
+            child++;
+        }
+        if (activity[heap[child]] <= activity[var]) {
+            break;
+        }
+        heap[position] = heap[child];
+        heapIndex[heap[position]] = static_cast<int>(position);
+        position = child;
+    }
+    heap[position] = var;
+    heapIndex[var] = static_cast<int>(position);
+}
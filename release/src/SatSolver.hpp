@@ -0,0 +1,94 @@
+#ifndef SAT_SOLVER_HPP
+#define SAT_SOLVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum SatResult { SAT_SATISFIABLE, SAT_UNSATISFIABLE, SAT_UNDECIDED };
+
+// Small conflict-driven clause-learning SAT solver in the style of MiniSat: two watched literals,
+// first-UIP learning with clause minimization, VSIDS branching with phase saving, Luby restarts and
+// activity-based deletion of learnt clauses. It is incremental: variables and clauses can be added
+// between solve calls, learnt clauses are kept, and every call solves under its own assumptions.
+//
+// A literal is 2 * var for the variable and 2 * var + 1 for its negation.
+class SatSolver {
+public:
+    SatSolver();
+
+    int newVar();
+    size_t numVars() const;
+    // Only decision variables are branched on; the others must be implied by them, as the internal
+    // nodes of a circuit are by its inputs. New variables are decision variables.
+    void setDecision(int var, bool decision);
+
+    // Returns false once the clauses are unsatisfiable without any assumptions
+    bool addClause(std::vector<int> literals);
+    // Solve with the assumption literals held true; gives up after conflictLimit conflicts (0 for no limit)
+    SatResult solve(const std::vector<int>& assumptions, size_t conflictLimit);
+    // Value of a variable in the satisfying assignment found by the last solve; variables that are
+    // neither decision variables nor implied by them read as false
+    bool modelValue(int var) const;
+
+    size_t conflicts() const;
+
+private:
+    struct Clause {
+        std::vector<int> literals;  // In a reason clause, the implied literal is first
+        bool learnt;
+        bool deleted;
+        double activity;
+    };
+
+    struct Watcher {
+        uint32_t clause;
+        int blocker;  // A literal of the clause; if it is true the clause need not be visited
+    };
+
+    static const uint32_t kNoReason = ~0u;
+
+    bool ok;
+    std::vector<Clause> clauses;
+    std::vector<uint32_t> freeClauses;
+    std::vector<std::vector<Watcher>> watches;  // Per literal, the clauses visited when it becomes false
+    std::vector<uint8_t> assigns;               // Per variable: 0 false, 1 true, 2 unassigned
+    std::vector<int> levels;
+    std::vector<uint32_t> reasons;
+    std::vector<uint8_t> polarity;  // Sign of the last assignment
+    std::vector<uint8_t> seen;
+    std::vector<uint8_t> decisions;
+    std::vector<double> activity;
+    std::vector<int> heap;          // Unassigned variable candidates, a max-heap on activity
+    std::vector<int> heapIndex;     // -1 if not in the heap
+    std::vector<int> trail;
+    std::vector<size_t> trailLimits;
+    size_t head;
+    std::vector<uint8_t> model;
+    double varIncrement;
+    double clauseIncrement;
+    size_t learntCount;
+    size_t maxLearnts;
+    size_t conflictCount;
+
+    int value(int literal) const;
+    size_t decisionLevel() const;
+    void enqueue(int literal, uint32_t reason);
+    uint32_t attachClause(const std::vector<int>& literals, bool learnt);
+    uint32_t propagate();
+    void analyze(uint32_t conflict, std::vector<int>& learnt, size_t& backtrackLevel);
+    void cancelUntil(size_t level);
+    int pickBranch();
+    // 1 satisfiable, 0 unsatisfiable, -1 restart, -2 conflict limit reached
+    int search(const std::vector<int>& assumptions, size_t restartConflicts, size_t conflictEnd);
+    void reduceLearnts();
+    void bumpVariable(int var);
+    void bumpClause(Clause& clause);
+
+    void heapInsert(int var);
+    int heapPop();
+    void heapUp(size_t position);
+    void heapDown(size_t position);
+};
+
+#endif // SAT_SOLVER_HPP
@@ -0,0 +1,302 @@
+#include "SatSweeper.hpp"
+#include <algorithm>
+
+static const size_t kSimWords = 8;        // 512 random patterns per node
+static const size_t kMaxCexWords = 64;    // Room for 4096 counterexample patterns
+static const size_t kMaxCandidates = 4;   // SAT checks per node before it starts a class of its own
+static const size_t kRecycleVars = 50000; // Solver variables after which the solver starts afresh
+
+SatSweeper::SatSweeper(const Aig& aig, Random& random, size_t conflictLimit, size_t checkFrom)
+    : source(aig), conflictLimit(conflictLimit), checkFrom(checkFrom), patternCount(0), coneStamp(0), calls(0), mergedNodes(0), refutedPairs(0),
+      undecidedPairs(0) {
+    inputWords.resize(aig.numInputs());
+    for (auto& words : inputWords) {
+        words.resize(kSimWords);
+        for (auto& word : words) {
+            word = random.next();
+        }
+        // Pattern 0 sets every input to 0, so a signature's first bit is the node's value for it
+        words[0] &= ~1ULL;
+    }
+}
+
+void SatSweeper::sweep() {
+    mapping.assign(source.numNodes(), Aig::kFalse);
+    replacement.assign(1, Aig::kFalse);
+    simulate(0);
+    classes[signatureHash(0)].push_back(0);
+    for (uint32_t node = 1; node < source.numNodes(); ++node) {
+        if (source.isInput(node)) {
+            uint32_t literal = swept.addInput();
+            replacement.push_back(literal);
+            simulate(literal >> 1);
+            classes[signatureHash(literal >> 1)].push_back(literal >> 1);
+            mapping[node] = literal;
+        } else {
+            uint32_t a = map(source.fanin0(node));
+            uint32_t b = map(source.fanin1(node));
+            mapping[node] = addNode(swept.makeAnd(a, b), node >= checkFrom);
+        }
+    }
+}
+
+uint32_t SatSweeper::map(uint32_t literal) const {
+    return mapping[literal >> 1] ^ (literal & 1);
+}
+
+uint32_t SatSweeper::addNode(uint32_t literal, bool check) {
+    uint32_t node = literal >> 1;
+    if (node >= replacement.size()) {
+        // A new node; structurally known nodes and folded constants or fanins keep their replacement
+        replacement.push_back(literal & ~1u);
+        simulate(node);
+        replacement[node] = findEquivalent(node, check);
+    }
+    return replacement[node] ^ (literal & 1);
+}
+
+void SatSweeper::simulate(uint32_t node) {
+    signatures.resize((node + 1) * kSimWords);
+    for (auto& word : patterns) {
+        word.resize(node + 1);
+    }
+    uint64_t* signature = &signatures[node * kSimWords];
+    if (node == 0) {
+        std::fill(signature, signature + kSimWords, 0);
+        for (auto& word : patterns) {
+            word[node] = 0;
+        }
+    } else if (swept.isInput(node)) {
+        const std::vector<uint64_t>& words = inputWords[swept.inputIndex(node)];
+        std::copy(words.begin(), words.end(), signature);
+        for (auto& word : patterns) {
+            word[node] = 0;
+        }
+    } else {
+        uint32_t a = swept.fanin0(node);
+        uint32_t b = swept.fanin1(node);
+        uint64_t maskA = (a & 1) ? ~0ULL : 0;
+        uint64_t maskB = (b & 1) ? ~0ULL : 0;
+        for (size_t w = 0; w < kSimWords; ++w) {
+            signature[w] = (signatures[(a >> 1) * kSimWords + w] ^ maskA) & (signatures[(b >> 1) * kSimWords + w] ^ maskB);
+        }
+        for (auto& word : patterns) {
+            word[node] = (word[a >> 1] ^ maskA) & (word[b >> 1] ^ maskB);
+        }
+    }
+}
+
+uint64_t SatSweeper::signatureHash(uint32_t node) const {
+    // Hash of the signature normalized to a 0 for pattern 0, so that complementary nodes share a class
+    const uint64_t* signature = &signatures[node * kSimWords];
+    uint64_t mask = (signature[0] & 1) ? ~0ULL : 0;
+    uint64_t hash = 0;
+    for (size_t w = 0; w < kSimWords; ++w) {
+        hash = (hash ^ (signature[w] ^ mask)) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+bool SatSweeper::sameSignature(uint32_t a, uint32_t b, bool inverted) const {
+    uint64_t mask = inverted ? ~0ULL : 0;
+    for (size_t w = 0; w < kSimWords; ++w) {
+        if (signatures[a * kSimWords + w] != (signatures[b * kSimWords + w] ^ mask)) {
+            return false;
+        }
+    }
+    for (size_t w = 0; w < patterns.size(); ++w) {
+        size_t bits = patternCount - w * 64;
+        uint64_t valid = bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+        if (((patterns[w][a] ^ patterns[w][b] ^ mask) & valid) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t SatSweeper::findEquivalent(uint32_t node, bool check) {
+    std::vector<uint32_t>& members = classes[signatureHash(node)];
+    if (!check) {
+        members.push_back(node);
+        return 2 * node;
+    }
+    bool phase = (signatures[node * kSimWords] & 1) != 0;
+    size_t candidates = 0;
+    for (uint32_t member : members) {
+        bool inverted = phase != ((signatures[member * kSimWords] & 1) != 0);
+        if (!sameSignature(node, member, inverted)) {
+            continue;
+        }
+        if (candidates++ == kMaxCandidates) {
+            break;
+        }
+        uint32_t memberLiteral = 2 * member + (inverted ? 1 : 0);
+        std::vector<bool> counterexample;
+        SatResult result = prove(2 * node, memberLiteral, conflictLimit, &counterexample);
+        if (result == SAT_UNSATISFIABLE) {
+            mergedNodes++;
+            return memberLiteral;
+        }
+        if (result == SAT_SATISFIABLE) {
+            refutedPairs++;
+            addPattern(counterexample);
+        } else {
+            undecidedPairs++;
+        }
+    }
+    members.push_back(node);
+    return 2 * node;
+}
+
+void SatSweeper::addPattern(const std::vector<bool>& inputs) {
+    if (patternCount == kMaxCexWords * 64) {
+        return;
+    }
+    if (patternCount % 64 == 0) {
+        patterns.emplace_back(swept.numNodes(), 0);
+    }
+    std::vector<uint64_t>& word = patterns.back();
+    uint64_t bit = 1ULL << (patternCount % 64);
+    patternCount++;
+    auto value = [&](uint32_t literal) {
+        return ((word[literal >> 1] & bit) != 0) != ((literal & 1) != 0);
+    };
+    for (uint32_t node = 1; node < swept.numNodes(); ++node) {
+        bool result;
+        if (swept.isInput(node)) {
+            size_t index = swept.inputIndex(node);
+            result = index < inputs.size() && inputs[index];
+        } else {
+            result = value(swept.fanin0(node)) && value(swept.fanin1(node));
+        }
+        if (result) {
+            word[node] |= bit;
+        }
+    }
+}
+
+int SatSweeper::satLiteral(uint32_t literal) {
+    satVars.resize(swept.numNodes(), -1);
+    std::vector<uint32_t> stack(1, literal >> 1);
+    while (!stack.empty()) {
+        uint32_t node = stack.back();
+        if (satVars[node] >= 0) {
+            stack.pop_back();
+            continue;
+        }
+        if (node == 0 || swept.isInput(node)) {
+            satVars[node] = solver->newVar();
+            if (node == 0) {
+                solver->addClause({2 * satVars[node] + 1});
+            }
+            stack.pop_back();
+            continue;
+        }
+        uint32_t a = swept.fanin0(node);
+        uint32_t b = swept.fanin1(node);
+        if (satVars[a >> 1] < 0 || satVars[b >> 1] < 0) {
+            // Load the fanins first
+            if (satVars[a >> 1] < 0) {
+                stack.push_back(a >> 1);
+            }
+            if (satVars[b >> 1] < 0) {
+                stack.push_back(b >> 1);
+            }
+            continue;
+        }
+        // Tseitin encoding of node = a & b
+        int out = 2 * solver->newVar();
+        int x = 2 * satVars[a >> 1] + static_cast<int>(a & 1);
+        int y = 2 * satVars[b >> 1] + static_cast<int>(b & 1);
+        solver->addClause({out ^ 1, x});
+        solver->addClause({out ^ 1, y});
+        solver->addClause({out, x ^ 1, y ^ 1});
+        satVars[node] = out >> 1;
+        stack.pop_back();
+    }
+    return 2 * satVars[literal >> 1] + static_cast<int>(literal & 1);
+}
+
+void SatSweeper::restrictDecisions(uint32_t a, uint32_t b) {
+    // Branching outside the two cones only finds conflicts that have nothing to do with the check
+    for (int var : decisionVars) {
+        solver->setDecision(var, false);
+    }
+    decisionVars.clear();
+    coneMarks.resize(swept.numNodes(), 0);
+    coneStamp++;
+    std::vector<uint32_t> stack = {a >> 1, b >> 1};
+    while (!stack.empty()) {
+        uint32_t node = stack.back();
+        stack.pop_back();
+        if (coneMarks[node] == coneStamp) {
+            continue;
+        }
+        coneMarks[node] = coneStamp;
+        decisionVars.push_back(satVars[node]);
+        solver->setDecision(satVars[node], true);
+        if (node != 0 && !swept.isInput(node)) {
+            stack.push_back(swept.fanin0(node) >> 1);
+            stack.push_back(swept.fanin1(node) >> 1);
+        }
+    }
+}
+
+SatResult SatSweeper::prove(uint32_t a, uint32_t b, size_t conflictLimit, std::vector<bool>* counterexample) {
+    if (a == b) {
+        return SAT_UNSATISFIABLE;
+    }
+    if (solver && solver->numVars() > kRecycleVars) {
+        solver.reset();
+    }
+    if (!solver) {
+        solver.reset(new SatSolver());
+        satVars.assign(swept.numNodes(), -1);
+        decisionVars.clear();
+    }
+    int x = satLiteral(a);
+    int y = satLiteral(b);
+    restrictDecisions(a, b);
+    // a != b holds with a true and b false, or the other way round
+    const int assumptions[2][2] = {{x, y ^ 1}, {x ^ 1, y}};
+    for (const auto& pair : assumptions) {
+        calls++;
+        SatResult result = solver->solve(std::vector<int>(pair, pair + 2), conflictLimit);
+        if (result == SAT_UNDECIDED) {
+            return result;
+        }
+        if (result == SAT_SATISFIABLE) {
+            if (counterexample) {
+                counterexample->assign(swept.numInputs(), false);
+                for (uint32_t node = 1; node < swept.numNodes() && node < satVars.size(); ++node) {
+                    if (swept.isInput(node) && satVars[node] >= 0) {
+                        (*counterexample)[swept.inputIndex(node)] = solver->modelValue(satVars[node]);
+                    }
+                }
+            }
+            return result;
+        }
+    }
+    return SAT_UNSATISFIABLE;
+}
+
+size_t SatSweeper::satCalls() const {
+    return calls;
+}
+
+size_t SatSweeper::merged() const {
+    return mergedNodes;
+}
+
+size_t SatSweeper::refuted() const {
+    return refutedPairs;
+}
+
+size_t SatSweeper::undecided() const {
+    return undecidedPairs;
+}
+
+size_t SatSweeper::sweptNodes() const {
+    return swept.numNodes();
+}
@@ -0,0 +1,75 @@
+#ifndef SAT_SWEEPER_HPP
+#define SAT_SWEEPER_HPP
+
+#include "Aig.hpp"
+#include "Random.hpp"
+#include "SatSolver.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// SAT sweeping of an AIG. The AIG is rebuilt node by node in topological order while every new node
+// is simulated on random patterns; a node whose simulation signature matches an earlier node, up to
+// inversion, is checked against it with the SAT solver and merged into it when they are proven equal.
+// Later nodes are then built on the merged node, so their cones, and the SAT problems that cover them,
+// stay small. A disproof yields an input pattern that is added to the signatures of all nodes, which
+// separates the pair and every later candidate that differs in the same way.
+//
+// Nodes before checkFrom are only simulated, not checked. For a miter of two netlists built one after
+// the other, starting the checks at the first node of the second one skips the internal equivalences of
+// the first, which the proof of the outputs does not need.
+class SatSweeper {
+public:
+    // conflictLimit bounds each candidate check; pairs left undecided are not merged
+    SatSweeper(const Aig& aig, Random& random, size_t conflictLimit, size_t checkFrom = 0);
+
+    void sweep();
+    // The literal of the swept AIG that a literal of the given AIG maps to
+    uint32_t map(uint32_t literal) const;
+
+    // Check two literals of the swept AIG for equality; a refutation fills the counterexample with the
+    // values of the inputs, in input order
+    SatResult prove(uint32_t a, uint32_t b, size_t conflictLimit, std::vector<bool>* counterexample);
+
+    size_t satCalls() const;
+    size_t merged() const;
+    size_t refuted() const;
+    size_t undecided() const;
+    size_t sweptNodes() const;
+
+private:
+    const Aig& source;
+    size_t conflictLimit;
+    size_t checkFrom;
+    Aig swept;
+    std::vector<uint32_t> mapping;      // Source node -> swept literal
+    std::vector<uint32_t> replacement;  // Swept node -> literal it was merged into, or its own literal
+    std::vector<uint64_t> signatures;   // Random patterns, kSimWords per swept node
+    std::vector<std::vector<uint64_t>> patterns;  // Counterexample patterns, 64 per word, one word per swept node
+    size_t patternCount;
+    std::vector<std::vector<uint64_t>> inputWords;  // Random words per input
+    std::unordered_map<uint64_t, std::vector<uint32_t>> classes;  // Signature hash -> class representatives
+
+    std::unique_ptr<SatSolver> solver;
+    std::vector<int> satVars;  // Swept node -> solver variable, -1 if not loaded
+    std::vector<int> decisionVars;  // Variables of the cones of the current check
+    std::vector<uint32_t> coneMarks;
+    uint32_t coneStamp;
+    size_t calls;
+    size_t mergedNodes;
+    size_t refutedPairs;
+    size_t undecidedPairs;
+
+    uint32_t addNode(uint32_t literal, bool check);
+    void simulate(uint32_t node);
+    uint64_t signatureHash(uint32_t node) const;
+    bool sameSignature(uint32_t a, uint32_t b, bool inverted) const;
+    uint32_t findEquivalent(uint32_t node, bool check);
+    void addPattern(const std::vector<bool>& inputs);
+    int satLiteral(uint32_t literal);
+    void restrictDecisions(uint32_t a, uint32_t b);
+};
+
+#endif // SAT_SWEEPER_HPP
@@ -0,0 +1,84 @@
+#include "SearchBudget.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const double kSecondsPerGate = 2.0;
+static const double kMinTimeLimit = 600.0;    // Ten minutes
+static const double kMaxTimeLimit = 10800.0;  // Three hours, the contest runtime limit
+
+SearchBudget::SearchBudget(double timeLimitSeconds, size_t maxEvaluations, size_t stallEvaluations, double stallEpsilon)
+    : start(std::chrono::steady_clock::now()), timeLimitSeconds(timeLimitSeconds), maxEvaluations(maxEvaluations),
+      stallEvaluations(stallEvaluations), stallEpsilon(stallEpsilon), haveBest(false), referenceCost(0.0f),
+      referenceEvaluations(0), stopReason(""), aborted(false) {}
+
+bool SearchBudget::exhausted(size_t evaluations) {
+    if (aborted) {
+        return true;
+    }
+    if (timeLimitSeconds > 0.0 && elapsedSeconds() >= timeLimitSeconds) {
+        stopReason = "time limit";
+        return true;
+    }
+    if (maxEvaluations > 0 && evaluations >= maxEvaluations) {
+        stopReason = "evaluation limit";
+        return true;
+    }
+    if (stallEvaluations > 0 && haveBest && evaluations - referenceEvaluations >= stallEvaluations) {
+        stopReason = "no improvement";
+        return true;
+    }
+    return false;
+}
+
+void SearchBudget::improve(float bestCost, size_t evaluations) {
+    // Improvements within epsilon of the reference do not reset the stall counter
+    if (!haveBest || referenceCost - bestCost > stallEpsilon * std::fabs(referenceCost)) {
+        haveBest = true;
+        referenceCost = bestCost;
+        referenceEvaluations = evaluations;
+    }
+}
+
+void SearchBudget::abort(const char* reason) {
+    aborted = true;
+    stopReason = reason;
+}
+
+const char* SearchBudget::reason() const {
+    return stopReason;
+}
+
+double SearchBudget::elapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SearchBudget::save(CheckpointWriter& out) const {
+    out.put(elapsedSeconds());
+    out.put(haveBest);
+    out.put(referenceCost);
+    out.put<uint64_t>(referenceEvaluations);
+}
+
+bool SearchBudget::load(CheckpointReader& in) {
+    double elapsed;
+    uint64_t evaluations;
+    if (!in.get(elapsed) || !in.get(haveBest) || !in.get(referenceCost) || !in.get(evaluations)) {
+        return false;
+    }
+    start = std::chrono::steady_clock::now() -
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(elapsed));
+    referenceEvaluations = evaluations;
+    return true;
+}
+
+double SearchBudget::progress(size_t evaluations) const {
+    double used = timeLimitSeconds > 0.0 ? elapsedSeconds() / timeLimitSeconds : 0.0;
+    if (maxEvaluations > 0) {
+        used = std::max(used, static_cast<double>(evaluations) / maxEvaluations);
+    }
+    return std::min(used, 1.0);
+}
+
+double SearchBudget::policyTimeLimit(size_t numGates) {
+    return std::min(std::max(kSecondsPerGate * numGates, kMinTimeLimit), kMaxTimeLimit);
+}
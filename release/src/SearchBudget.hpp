@@ -0,0 +1,48 @@
+#ifndef SEARCH_BUDGET_HPP
+#define SEARCH_BUDGET_HPP
+
+#include "Checkpoint.hpp"
+#include <chrono>
+#include <cstddef>
+
+// Stopping rules of a search run: a wall-clock limit, a limit on estimator evaluations and stall
+// detection. A run stalls when the best cost has not improved by more than a relative epsilon
+// within the last stallEvaluations evaluations.
+class SearchBudget {
+public:
+    SearchBudget(double timeLimitSeconds, size_t maxEvaluations, size_t stallEvaluations, double stallEpsilon);
+
+    // True once any limit is reached; evaluations is the number of estimator runs so far
+    bool exhausted(size_t evaluations);
+    // Report the best cost after it changed
+    void improve(float bestCost, size_t evaluations);
+    // Make exhausted() return true from now on, e.g. when the estimator cannot be run
+    void abort(const char* reason);
+
+    // Why exhausted() returned true
+    const char* reason() const;
+    double elapsedSeconds() const;
+    // Share of the time or evaluation limit used so far, whichever is larger, capped at 1
+    double progress(size_t evaluations) const;
+
+    // The elapsed time and stall reference; a loaded budget continues the clock of the saved one
+    void save(CheckpointWriter& out) const;
+    bool load(CheckpointReader& in);
+
+    // Default wall-clock limit for a design: about two seconds per gate, between ten minutes and three hours
+    static double policyTimeLimit(size_t numGates);
+
+private:
+    std::chrono::steady_clock::time_point start;
+    double timeLimitSeconds;
+    size_t maxEvaluations;
+    size_t stallEvaluations;
+    double stallEpsilon;
+    bool haveBest;
+    float referenceCost;         // Best cost at the last significant improvement
+    size_t referenceEvaluations; // Evaluations at the last significant improvement
+    const char* stopReason;
+    bool aborted;
+};
+
+#endif // SEARCH_BUDGET_HPP
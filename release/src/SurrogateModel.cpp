@@ -0,0 +1,212 @@
+#include "SurrogateModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+static const size_t kMinFitSamples = 32;  // Samples needed before predictions are trusted
+static const double kRidge = 1e-3;        // Regularization on the normalized normal equations
+
+SurrogateModel::SurrogateModel(const Netlist& netlist, const CellTable& cellTable, size_t refitInterval)
+    : refitInterval(std::max<size_t>(refitInterval, 1)), numAttributes(0), samples(0), samplesAtFit(0),
+      absoluteErrorSum(0.0), errorCount(0) {
+    for (size_t i = 0; i < cellTable.numCells(); ++i) {
+        const Cell& cell = cellTable.cell(static_cast<uint16_t>(i));
+        numAttributes = std::max(numAttributes, cell.float_data.size() + cell.int_data.size());
+    }
+    for (size_t i = 0; i < cellTable.numCells(); ++i) {
+        const Cell& cell = cellTable.cell(static_cast<uint16_t>(i));
+        if (typeIndex.find(cell.cell_type) == typeIndex.end()) {
+            size_t index = typeIndex.size();
+            typeIndex[cell.cell_type] = index;
+        }
+        std::vector<double> attributes(cell.float_data.begin(), cell.float_data.end());
+        attributes.insert(attributes.end(), cell.int_data.begin(), cell.int_data.end());
+        attributes.resize(numAttributes, 0.0);
+        cellAttributes.push_back(attributes);
+    }
+    for (const auto& gate : netlist.gates) {
+        auto it = typeIndex.find(gate.type);
+        gateTypes.push_back(it != typeIndex.end() ? it->second : typeIndex.size());
+    }
+
+    size_t d = dimension();
+    xtx.assign(d * d, 0.0);
+    xty.assign(d, 0.0);
+    weights.assign(d, 0.0);
+}
+
+size_t SurrogateModel::dimension() const {
+    return typeIndex.size() * (numAttributes + 1) + 1;
+}
+
+size_t SurrogateModel::typeOffset(size_t type) const {
+    return type * (numAttributes + 1);
+}
+
+std::vector<double> SurrogateModel::features(const CellAssignment& assignment) const {
+    std::vector<double> x(dimension(), 0.0);
+    x.back() = 1.0;
+    for (size_t i = 0; i < assignment.size(); ++i) {
+        if (gateTypes[i] >= typeIndex.size() || assignment[i] == kNoCell) {
+            continue;
+        }
+        const std::vector<double>& attributes = cellAttributes[assignment[i]];
+        size_t offset = typeOffset(gateTypes[i]);
+        x[offset] += 1.0;
+        for (size_t a = 0; a < numAttributes; ++a) {
+            x[offset + 1 + a] += attributes[a];
+        }
+    }
+    return x;
+}
+
+void SurrogateModel::applyMove(std::vector<double>& features, const CellMove& move) const {
+    if (gateTypes[move.gate] >= typeIndex.size() || move.oldCell == kNoCell || move.newCell == kNoCell) {
+        return;
+    }
+    const std::vector<double>& oldAttributes = cellAttributes[move.oldCell];
+    const std::vector<double>& newAttributes = cellAttributes[move.newCell];
+    size_t offset = typeOffset(gateTypes[move.gate]) + 1;
+    for (size_t a = 0; a < numAttributes; ++a) {
+        features[offset + a] += newAttributes[a] - oldAttributes[a];
+    }
+}
+
+void SurrogateModel::addSample(const std::vector<double>& features, float cost) {
+    if (!std::isfinite(cost) || cost >= std::numeric_limits<float>::max()) {
+        return;  // Failed estimator runs carry no information
+    }
+    if (ready()) {
+        absoluteErrorSum += std::fabs(predict(features) - cost);
+        errorCount++;
+    }
+
+    size_t d = dimension();
+    for (size_t i = 0; i < d; ++i) {
+        if (features[i] == 0.0) {
+            continue;
+        }
+        for (size_t j = 0; j < d; ++j) {
+            xtx[i * d + j] += features[i] * features[j];
+        }
+        xty[i] += features[i] * cost;
+    }
+    samples++;
+
+    if (samples >= kMinFitSamples && samples - samplesAtFit >= refitInterval) {
+        refit();
+    }
+}
+
+void SurrogateModel::refit() {
+    size_t d = dimension();
+
+    // Normalize the columns so the ridge term treats all features alike
+    std::vector<double> scale(d, 1.0);
+    for (size_t i = 0; i < d; ++i) {
+        if (xtx[i * d + i] > 0.0) {
+            scale[i] = std::sqrt(xtx[i * d + i]);
+        }
+    }
+    std::vector<double> a(d * d);
+    std::vector<double> b(d);
+    for (size_t i = 0; i < d; ++i) {
+        for (size_t j = 0; j < d; ++j) {
+            a[i * d + j] = xtx[i * d + j] / (scale[i] * scale[j]);
+        }
+        a[i * d + i] += kRidge;
+        b[i] = xty[i] / scale[i];
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (size_t col = 0; col < d; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < d; ++row) {
+            if (std::fabs(a[row * d + col]) > std::fabs(a[pivot * d + col])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(a[pivot * d + col]) < 1e-12) {
+            continue;
+        }
+        if (pivot != col) {
+            for (size_t j = 0; j < d; ++j) {
+                std::swap(a[col * d + j], a[pivot * d + j]);
+            }
+            std::swap(b[col], b[pivot]);
+        }
+        for (size_t row = col + 1; row < d; ++row) {
+            double factor = a[row * d + col] / a[col * d + col];
+            if (factor == 0.0) {
+                continue;
+            }
+            for (size_t j = col; j < d; ++j) {
+                a[row * d + j] -= factor * a[col * d + j];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+    std::vector<double> z(d, 0.0);
+    for (size_t i = d; i-- > 0;) {
+        if (std::fabs(a[i * d + i]) < 1e-12) {
+            continue;
+        }
+        double sum = b[i];
+        for (size_t j = i + 1; j < d; ++j) {
+            sum -= a[i * d + j] * z[j];
+        }
+        z[i] = sum / a[i * d + i];
+    }
+    for (size_t i = 0; i < d; ++i) {
+        weights[i] = z[i] / scale[i];
+    }
+    samplesAtFit = samples;
+}
+
+bool SurrogateModel::ready() const {
+    return samplesAtFit >= kMinFitSamples;
+}
+
+double SurrogateModel::predict(const std::vector<double>& features) const {
+    double prediction = 0.0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        prediction += weights[i] * features[i];
+    }
+    return prediction;
+}
+
+size_t SurrogateModel::sampleCount() const {
+    return samples;
+}
+
+double SurrogateModel::meanAbsoluteError() const {
+    return errorCount == 0 ? 0.0 : absoluteErrorSum / errorCount;
+}
+
+void SurrogateModel::save(CheckpointWriter& out) const {
+    out.putVector(xtx);
+    out.putVector(xty);
+    out.putVector(weights);
+    out.put<uint64_t>(samples);
+    out.put<uint64_t>(samplesAtFit);
+    out.put(absoluteErrorSum);
+    out.put<uint64_t>(errorCount);
+}
+
+bool SurrogateModel::load(CheckpointReader& in) {
+    std::vector<double> loadedXtx, loadedXty, loadedWeights;
+    uint64_t loadedSamples, loadedSamplesAtFit, loadedErrorCount;
+    if (!in.getVector(loadedXtx) || !in.getVector(loadedXty) || !in.getVector(loadedWeights) || !in.get(loadedSamples) ||
+        !in.get(loadedSamplesAtFit) || !in.get(absoluteErrorSum) || !in.get(loadedErrorCount) ||
+        loadedXtx.size() != xtx.size() || loadedXty.size() != xty.size() || loadedWeights.size() != weights.size()) {
+        return false;
+    }
+    xtx = loadedXtx;
+    xty = loadedXty;
+    weights = loadedWeights;
+    samples = loadedSamples;
+    samplesAtFit = loadedSamplesAtFit;
+    errorCount = loadedErrorCount;
+    return true;
+}
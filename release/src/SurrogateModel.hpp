@@ -0,0 +1,54 @@
+#ifndef SURROGATE_MODEL_HPP
+#define SURROGATE_MODEL_HPP
+
+#include "CellAssignment.hpp"
+#include "Checkpoint.hpp"
+#include "CellLibraryParser.hpp"
+#include "NetlistParser.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Online ridge regression approximating the external cost estimator. A mapping is described by,
+// for every gate type, the sums of the float_data/int_data attributes of the cells its gates use,
+// plus the number of gates of that type and a bias term. The model is refit every refitInterval samples.
+class SurrogateModel {
+public:
+    SurrogateModel(const Netlist& netlist, const CellTable& cellTable, size_t refitInterval);
+
+    std::vector<double> features(const CellAssignment& assignment) const;
+    // Update features in place for one gate moving from move.oldCell to move.newCell
+    void applyMove(std::vector<double>& features, const CellMove& move) const;
+
+    void addSample(const std::vector<double>& features, float cost);
+    bool ready() const;
+    double predict(const std::vector<double>& features) const;
+
+    size_t sampleCount() const;
+    double meanAbsoluteError() const;  // Error on samples before they were learned
+
+    // The accumulated normal equations, fitted weights and error statistics
+    void save(CheckpointWriter& out) const;
+    bool load(CheckpointReader& in);
+
+private:
+    size_t refitInterval;
+    size_t numAttributes;
+    std::unordered_map<std::string, size_t> typeIndex;
+    std::vector<std::vector<double>> cellAttributes;  // Indexed by cell id
+    std::vector<size_t> gateTypes;
+
+    std::vector<double> xtx;  // Accumulated X^T X, row major
+    std::vector<double> xty;  // Accumulated X^T y
+    std::vector<double> weights;
+    size_t samples;
+    size_t samplesAtFit;
+    double absoluteErrorSum;
+    size_t errorCount;
+
+    size_t dimension() const;
+    size_t typeOffset(size_t type) const;
+    void refit();
+};
+
+#endif // SURROGATE_MODEL_HPP
@@ -0,0 +1,184 @@
+#include "SwitchingActivity.hpp"
+#include "NetlistGraph.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+static const size_t kBlockWords = 16;  // 1024 cycles per simulation pass
+
+SwitchingActivity::SwitchingActivity(const Netlist& netlist) : SwitchingActivity(netlist, std::vector<GateFunction>()) {}
+
+SwitchingActivity::SwitchingActivity(const Netlist& netlist, const std::vector<GateFunction>& functions)
+    : netlist(netlist), functions(netlist.gates.size()), order(NetlistGraph(netlist).order()), gateInputs(netlist.gates.size()),
+      gateProbabilities(netlist.gates.size(), 0.0), gateToggleRates(netlist.gates.size(), 0.0) {
+    std::unordered_map<std::string, uint32_t> nets;
+    nets["1'b0"] = 0;
+    nets["1'b1"] = 1;
+    numNets = 2;
+    for (const auto& input : netlist.inputs) {
+        nets[input] = static_cast<uint32_t>(numNets++);
+    }
+    for (size_t gate = 0; gate < netlist.gates.size(); ++gate) {
+        nets[netlist.gates[gate].output] = static_cast<uint32_t>(numNets++);
+        this->functions[gate] = gate < functions.size() ? functions[gate] : gateFunction(netlist.gates[gate].type);
+        if (this->functions[gate] == GATE_UNKNOWN && errorMessage.empty()) {
+            errorMessage = "Unsupported gate type " + netlist.gates[gate].type + " of gate " + netlist.gates[gate].name;
+        }
+    }
+    for (size_t gate = 0; gate < netlist.gates.size(); ++gate) {
+        for (const auto& input : netlist.gates[gate].inputs) {
+            // Undriven nets get nets of their own that stay at 0
+            auto it = nets.emplace(input, static_cast<uint32_t>(numNets));
+            if (it.second) {
+                numNets++;
+            }
+            gateInputs[gate].push_back(it.first->second);
+        }
+    }
+}
+
+const std::string& SwitchingActivity::error() const {
+    return errorMessage;
+}
+
+void SwitchingActivity::propagate(double inputProbability) {
+    std::vector<double> probability(numNets, 0.0);
+    probability[1] = 1.0;
+    for (size_t i = 0; i < netlist.inputs.size(); ++i) {
+        probability[2 + i] = inputProbability;
+    }
+
+    size_t gateNetBase = 2 + netlist.inputs.size();
+    for (size_t gate : order) {
+        const std::vector<uint32_t>& inputs = gateInputs[gate];
+        GateFunction function = functions[gate];
+        double p = 0.0;
+        if (!inputs.empty()) {
+            // Same folding as the simulator: AND folds multiply the input probabilities, OR folds those
+            // of the inputs being 0, and parity combines them pairwise
+            if (function == GATE_XOR || function == GATE_XNOR) {
+                for (uint32_t net : inputs) {
+                    p = p + probability[net] - 2.0 * p * probability[net];
+                }
+            } else if (function == GATE_OR || function == GATE_NOR) {
+                double zero = 1.0;
+                for (uint32_t net : inputs) {
+                    zero *= 1.0 - probability[net];
+                }
+                p = 1.0 - zero;
+            } else {
+                p = 1.0;
+                for (uint32_t net : inputs) {
+                    p *= probability[net];
+                }
+            }
+            if (function == GATE_NAND || function == GATE_NOR || function == GATE_XNOR || function == GATE_NOT) {
+                p = 1.0 - p;
+            }
+        }
+        probability[gateNetBase + gate] = p;
+        gateProbabilities[gate] = p;
+        // Independent cycles: the value differs from the previous one with probability 2p(1 - p)
+        gateToggleRates[gate] = 2.0 * p * (1.0 - p);
+    }
+}
+
+void SwitchingActivity::simulate(Random& random, size_t patterns, double inputProbability) {
+    LogicSimulator simulator(netlist, functions);
+    // Input words with bits set with probability threshold / 256: every step ORs or ANDs in a fresh
+    // random word, one per bit of the threshold from the lowest
+    unsigned threshold = static_cast<unsigned>(std::lround(std::min(std::max(inputProbability, 0.0), 1.0) * 256.0));
+    auto biasedWord = [&]() -> uint64_t {
+        if (threshold >= 256) {
+            return ~0ULL;
+        }
+        uint64_t word = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            word = (threshold >> bit & 1) ? (word | random.next()) : (word & random.next());
+        }
+        return word;
+    };
+
+    size_t gates = netlist.gates.size();
+    std::vector<uint64_t> ones(gates, 0);
+    std::vector<uint64_t> toggles(gates, 0);
+    std::vector<uint64_t> lastBits(gates, 0);
+    std::vector<uint64_t> inputs;
+    size_t cycles = 0;
+    patterns = std::max<size_t>(patterns, 64);
+    while (cycles < patterns) {
+        size_t words = std::min(kBlockWords, (patterns - cycles + 63) / 64);
+        inputs.resize(simulator.numInputs() * words);
+        for (auto& word : inputs) {
+            word = biasedWord();
+        }
+        simulator.simulate(inputs, words);
+        for (size_t gate = 0; gate < gates; ++gate) {
+            const uint64_t* values = simulator.values(simulator.gateNet(gate));
+            for (size_t w = 0; w < words; ++w) {
+                // Bit i is cycle 64 w + i; a toggle is a difference to the previous cycle
+                uint64_t previous = values[w] << 1 | (w > 0 ? values[w - 1] >> 63 : lastBits[gate]);
+                uint64_t changes = values[w] ^ previous;
+                if (cycles == 0 && w == 0) {
+                    changes &= ~1ULL;
+                }
+                ones[gate] += __builtin_popcountll(values[w]);
+                toggles[gate] += __builtin_popcountll(changes);
+            }
+            lastBits[gate] = values[words - 1] >> 63;
+        }
+        cycles += words * 64;
+    }
+    for (size_t gate = 0; gate < gates; ++gate) {
+        gateProbabilities[gate] = static_cast<double>(ones[gate]) / cycles;
+        gateToggleRates[gate] = static_cast<double>(toggles[gate]) / (cycles - 1);
+    }
+}
+
+size_t SwitchingActivity::numGates() const {
+    return gateProbabilities.size();
+}
+
+double SwitchingActivity::probability(size_t gate) const {
+    return gateProbabilities[gate];
+}
+
+double SwitchingActivity::toggleRate(size_t gate) const {
+    return gateToggleRates[gate];
+}
+
+bool SwitchingActivity::writeJson(const std::string& path, const std::string& mode) const {
+    json report;
+    report["mode"] = mode;
+    report["gates"] = netlist.gates.size();
+    double totalToggles = 0.0;
+    for (size_t gate = 0; gate < netlist.gates.size(); ++gate) {
+        json entry;
+        entry["gate"] = netlist.gates[gate].name;
+        entry["probability"] = gateProbabilities[gate];
+        entry["toggle_rate"] = gateToggleRates[gate];
+        report["nets"][netlist.gates[gate].output] = entry;
+        totalToggles += gateToggleRates[gate];
+    }
+    report["mean_toggle_rate"] = netlist.gates.empty() ? 0.0 : totalToggles / netlist.gates.size();
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not write activity file " << tempPath << std::endl;
+        return false;
+    }
+    out << report.dump(4) << std::endl;
+    out.close();
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not replace activity file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef SWITCHING_ACTIVITY_HPP
+#define SWITCHING_ACTIVITY_HPP
+
+#include "LogicSimulator.hpp"
+#include "NetlistParser.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Signal probabilities and toggle rates of the gate outputs of a combinational netlist, for power
+// models that weight the switching energy of a cell by how often its output changes. The primary
+// inputs are driven by a random sequence in which every input is 1 with a given probability,
+// independently per input and per cycle. With zero gate delay every net then takes independent
+// values in consecutive cycles as well, so a net that is 1 with probability p toggles with rate
+// 2p(1 - p); glitches are not counted.
+//
+// propagate is analytical: probabilities pass through the gates in topological order as if the gate
+// inputs were independent, which reconvergent fanout violates. simulate measures probabilities and
+// toggles on a bit-parallel simulated sequence instead and is exact up to sampling noise.
+class SwitchingActivity {
+public:
+    // Gate functions are taken from the gate types; the netlist must outlive the object
+    explicit SwitchingActivity(const Netlist& netlist);
+    // Gate functions given per gate, e.g. for a mapped netlist whose gate types are cell names
+    SwitchingActivity(const Netlist& netlist, const std::vector<GateFunction>& functions);
+
+    // Empty unless a gate type is not one of the supported functions
+    const std::string& error() const;
+
+    void propagate(double inputProbability);
+    // Simulates at least the given number of cycles, rounded up to a multiple of 64
+    void simulate(Random& random, size_t patterns, double inputProbability);
+
+    size_t numGates() const;
+    double probability(size_t gate) const;  // Of the gate output being 1
+    double toggleRate(size_t gate) const;   // Expected output transitions per input vector
+
+    // Per-net report of the last estimate, keyed by the net each gate drives
+    bool writeJson(const std::string& path, const std::string& mode) const;
+
+private:
+    const Netlist& netlist;
+    std::vector<GateFunction> functions;
+    std::vector<size_t> order;
+    std::vector<std::vector<uint32_t>> gateInputs;  // Nets: 0 and 1 the constants, then the inputs, then gate outputs
+    size_t numNets;
+    std::string errorMessage;
+    std::vector<double> gateProbabilities;
+    std::vector<double> gateToggleRates;
+};
+
+#endif // SWITCHING_ACTIVITY_HPP
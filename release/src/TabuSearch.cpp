@@ -0,0 +1,172 @@
+#include "TabuSearch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const size_t kMinTenure = 3;
+static const size_t kQuietTenures = 4;  // Tenures without a revisit before the tenure shrinks
+static const size_t kRevisitTenures = 4;  // Tenures a visited assignment is remembered; a later return is no cycle the tenure can break
+
+static uint64_t moveKey(size_t gate, uint16_t cell) {
+    return (static_cast<uint64_t>(gate) << 16) | cell;
+}
+
+TabuSearch::TabuSearch(const CellTable& cellTable, const MappingHasher& hasher, const BatchEvaluator& evaluate,
+                       size_t neighborhoodSize, size_t initialTenure)
+    : cellTable(cellTable), hasher(hasher), evaluate(evaluate), neighborhoodSize(std::max<size_t>(neighborhoodSize, 1)),
+      iteration(0), lastTenureChange(0), evaluationCount(0), aspirationCount(0), revisitCount(0) {
+    for (size_t i = 0; i < cellTable.numGates(); ++i) {
+        if (cellTable.candidates(i).size() > 1) {
+            movableGates.push_back(i);
+        }
+    }
+    // A tenure near the number of movable gates would leave little besides tabu moves to choose from
+    maxTenure = std::max(kMinTenure, movableGates.size() / 2);
+    minTenure = std::min(kMinTenure, maxTenure);
+    if (initialTenure == 0) {
+        initialTenure = static_cast<size_t>(std::sqrt(static_cast<double>(movableGates.size())));
+    }
+    currentTenure = std::min(std::max(initialTenure, minTenure), maxTenure);
+}
+
+size_t TabuSearch::evaluations() const {
+    return evaluationCount;
+}
+
+size_t TabuSearch::tenure() const {
+    return currentTenure;
+}
+
+size_t TabuSearch::aspirations() const {
+    return aspirationCount;
+}
+
+size_t TabuSearch::revisits() const {
+    return revisitCount;
+}
+
+void TabuSearch::reset(const CellAssignment& assignment) {
+    tabuUntil.clear();
+    visited.clear();
+    key = hasher.hash(assignment);
+    visited[key] = iteration;
+    lastTenureChange = iteration;
+}
+
+bool TabuSearch::isTabu(const CellMove& move) const {
+    auto it = tabuUntil.find(moveKey(move.gate, move.newCell));
+    return it != tabuUntil.end() && it->second > iteration;
+}
+
+void TabuSearch::makeTabu(size_t gate, uint16_t cell) {
+    // Expired entries are dropped once they outnumber the live ones
+    if (tabuUntil.size() > 2 * maxTenure) {
+        for (auto it = tabuUntil.begin(); it != tabuUntil.end();) {
+            it = it->second > iteration ? std::next(it) : tabuUntil.erase(it);
+        }
+    }
+    tabuUntil[moveKey(gate, cell)] = iteration + currentTenure;
+}
+
+void TabuSearch::adaptTenure(bool revisit) {
+    if (revisit) {
+        revisitCount++;
+        currentTenure = std::min(maxTenure, currentTenure + currentTenure / 5 + 1);
+        lastTenureChange = iteration;
+    } else if (iteration - lastTenureChange > kQuietTenures * currentTenure) {
+        currentTenure = std::max(minTenure, currentTenure * 4 / 5);
+        lastTenureChange = iteration;
+    }
+}
+
+bool TabuSearch::step(CellAssignment& assignment, float& cost, float bestCost, Random& random) {
+    iteration++;
+    if (movableGates.empty()) {
+        return false;
+    }
+
+    // Sample moves on distinct gates. Tabu moves are skipped unless the change seen when they were last
+    // evaluated would take them below the best cost, which is the only way they can be admitted.
+    std::vector<size_t> gates = movableGates;
+    std::vector<CellMove> moves, skipped;
+    std::vector<bool> tabu;
+    for (size_t i = 0; i < gates.size() && moves.size() < neighborhoodSize; ++i) {
+        std::swap(gates[i], gates[i + random.below(gates.size() - i)]);
+        size_t gate = gates[i];
+        const std::vector<uint16_t>& cells = cellTable.candidates(gate);
+        CellMove move;
+        move.gate = static_cast<uint32_t>(gate);
+        move.oldCell = assignment[gate];
+        move.newCell = cells[random.below(cells.size() - 1)];
+        if (move.newCell == move.oldCell) {
+            move.newCell = cells.back();
+        }
+        if (move.oldCell == kNoCell || move.newCell == move.oldCell) {
+            continue;
+        }
+        bool moveTabu = isTabu(move);
+        if (moveTabu) {
+            auto delta = lastDelta.find(moveKey(move.gate, move.newCell));
+            if (delta == lastDelta.end() || cost + delta->second >= bestCost) {
+                skipped.push_back(move);
+                continue;
+            }
+        }
+        moves.push_back(move);
+        tabu.push_back(moveTabu);
+    }
+    // Aspiration by default: with every sampled move tabu, the search continues through them anyway
+    bool allTabu = moves.empty();
+    if (allTabu) {
+        moves = skipped;
+        tabu.assign(moves.size(), false);
+    }
+    if (moves.empty()) {
+        return false;
+    }
+
+    std::vector<CellAssignment> neighbors;
+    for (const auto& move : moves) {
+        CellAssignment neighbor = assignment;
+        neighbor.apply(move);
+        neighbors.push_back(neighbor);
+    }
+    std::vector<float> costs = evaluate(neighbors);
+    evaluationCount += neighbors.size();
+
+    // Best admissible neighbor, worse than the current one or not
+    size_t chosen = moves.size();
+    for (size_t m = 0; m < moves.size(); ++m) {
+        if (costs[m] >= std::numeric_limits<float>::max()) {
+            continue;
+        }
+        lastDelta[moveKey(moves[m].gate, moves[m].newCell)] = costs[m] - cost;
+        if (tabu[m] && costs[m] >= bestCost) {
+            continue;
+        }
+        if (chosen == moves.size() || costs[m] < costs[chosen]) {
+            chosen = m;
+        }
+    }
+    if (chosen == moves.size()) {
+        return false;
+    }
+
+    const CellMove& move = moves[chosen];
+    aspirationCount += tabu[chosen] || allTabu ? 1 : 0;
+    assignment.apply(move);
+    cost = costs[chosen];
+    makeTabu(move.gate, move.oldCell);
+    key = hasher.update(key, move);
+    size_t window = kRevisitTenures * currentTenure;
+    auto seen = visited.find(key);
+    adaptTenure(seen != visited.end() && iteration - seen->second <= window);
+    // Like the tabu list, the visited assignments drop their stale entries once they outnumber the live ones
+    if (visited.size() > 2 * window) {
+        for (auto it = visited.begin(); it != visited.end();) {
+            it = iteration - it->second > window ? visited.erase(it) : std::next(it);
+        }
+    }
+    visited[key] = iteration;
+    return true;
+}
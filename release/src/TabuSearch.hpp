@@ -0,0 +1,61 @@
+#ifndef TABU_SEARCH_HPP
+#define TABU_SEARCH_HPP
+
+#include "CellAssignment.hpp"
+#include "CostCache.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Tabu search over single-gate moves. Every step evaluates a sample of the neighborhood as one batch and
+// moves to its best admissible neighbor, even when that is worse than the current assignment. Putting a
+// gate back on the cell it just left is tabu for a number of steps (the tenure), so the search does not
+// spend evaluations cycling between neighbors it has seen.
+//
+// A tabu move is still admissible when it leads to a new best cost (aspiration). Tabu moves are only
+// evaluated when the cost change last observed for them suggests they might, so aspiration costs few
+// evaluations, or when every sampled move is tabu. The tenure reacts to the search: it grows whenever a step revisits an assignment and
+// shrinks after a stretch of steps without revisits. Only returns within a few tenures count as revisits, so
+// the visited assignments older than that are forgotten.
+class TabuSearch {
+public:
+    TabuSearch(const CellTable& cellTable, const MappingHasher& hasher, const BatchEvaluator& evaluate,
+               size_t neighborhoodSize, size_t initialTenure);
+
+    // Forget the tabu list and visited assignments and restart from assignment
+    void reset(const CellAssignment& assignment);
+    // Take one step from assignment/cost; returns false when no neighbor could be evaluated
+    bool step(CellAssignment& assignment, float& cost, float bestCost, Random& random);
+
+    size_t evaluations() const;
+    size_t tenure() const;
+    size_t aspirations() const;
+    size_t revisits() const;
+
+private:
+    const CellTable& cellTable;
+    const MappingHasher& hasher;
+    BatchEvaluator evaluate;
+    size_t neighborhoodSize;
+    size_t minTenure;
+    size_t maxTenure;
+    size_t currentTenure;
+    size_t iteration;
+    size_t lastTenureChange;
+    size_t evaluationCount;
+    size_t aspirationCount;
+    size_t revisitCount;
+    std::vector<size_t> movableGates;
+    MappingKey key;
+    std::unordered_map<uint64_t, size_t> tabuUntil;   // Keyed by (gate << 16) | cell, step until which the move is tabu
+    std::unordered_map<uint64_t, float> lastDelta;    // Keyed like tabuUntil, cost change seen when last evaluated
+    std::unordered_map<MappingKey, size_t, MappingKeyHash> visited;  // Assignments moved to recently, with the step
+
+    bool isTabu(const CellMove& move) const;
+    void makeTabu(size_t gate, uint16_t cell);
+    void adaptTenure(bool revisit);
+};
+
+#endif // TABU_SEARCH_HPP
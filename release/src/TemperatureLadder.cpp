@@ -0,0 +1,83 @@
+#include "TemperatureLadder.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const double kAdaptGain = 1.0;       // Gap change per unit of acceptance difference, in log space
+static const double kMaxGapChange = 2.0;    // Largest factor a gap may grow or shrink by in one adaptation
+
+TemperatureLadder::TemperatureLadder(size_t size, double minTemp, double maxTemp)
+    : temperatures(std::max<size_t>(size, 1)) {
+    reset(minTemp, maxTemp);
+}
+
+size_t TemperatureLadder::size() const {
+    return temperatures.size();
+}
+
+double TemperatureLadder::temperature(size_t rung) const {
+    return temperatures[rung];
+}
+
+void TemperatureLadder::reset(double minTemp, double maxTemp) {
+    size_t n = temperatures.size();
+    for (size_t i = 0; i < n; ++i) {
+        double fraction = n > 1 ? static_cast<double>(i) / (n - 1) : 0.0;
+        temperatures[i] = minTemp * std::pow(maxTemp / minTemp, fraction);
+    }
+    attempts.assign(n > 1 ? n - 1 : 0, 0);
+    accepts.assign(attempts.size(), 0);
+}
+
+void TemperatureLadder::recordSwap(size_t rung, bool accepted) {
+    attempts[rung]++;
+    if (accepted) {
+        accepts[rung]++;
+    }
+}
+
+double TemperatureLadder::acceptanceRate(size_t rung) const {
+    return attempts[rung] > 0 ? static_cast<double>(accepts[rung]) / attempts[rung] : 0.0;
+}
+
+void TemperatureLadder::adapt() {
+    size_t gaps = attempts.size();
+    if (gaps < 2) {
+        return;
+    }
+
+    double meanRate = 0.0;
+    size_t measured = 0;
+    for (size_t i = 0; i < gaps; ++i) {
+        if (attempts[i] > 0) {
+            meanRate += acceptanceRate(i);
+            measured++;
+        }
+    }
+    if (measured == 0) {
+        return;
+    }
+    meanRate /= measured;
+
+    // Work on log temperature gaps so the ends stay put when the total is renormalized
+    std::vector<double> logGaps(gaps);
+    double total = 0.0;
+    double adjusted = 0.0;
+    for (size_t i = 0; i < gaps; ++i) {
+        logGaps[i] = std::log(temperatures[i + 1] / temperatures[i]);
+        total += logGaps[i];
+        if (attempts[i] > 0) {
+            double factor = std::exp(kAdaptGain * (acceptanceRate(i) - meanRate));
+            logGaps[i] *= std::min(std::max(factor, 1.0 / kMaxGapChange), kMaxGapChange);
+        }
+        adjusted += logGaps[i];
+    }
+    if (adjusted <= 0.0) {
+        return;
+    }
+    for (size_t i = 0; i < gaps; ++i) {
+        temperatures[i + 1] = temperatures[i] * std::exp(logGaps[i] * total / adjusted);
+    }
+
+    attempts.assign(gaps, 0);
+    accepts.assign(gaps, 0);
+}
@@ -0,0 +1,33 @@
+#ifndef TEMPERATURE_LADDER_HPP
+#define TEMPERATURE_LADDER_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Temperatures of the parallel tempering replicas, coldest first. The ladder adapts by widening gaps
+// whose replica exchanges are accepted more often than average and narrowing the others, which drives
+// the exchange acceptance towards being equal along the ladder while keeping both ends fixed.
+class TemperatureLadder {
+public:
+    TemperatureLadder(size_t size, double minTemp, double maxTemp);
+
+    size_t size() const;
+    double temperature(size_t rung) const;
+
+    // Place the rungs geometrically between minTemp and maxTemp and forget the exchange statistics
+    void reset(double minTemp, double maxTemp);
+
+    // Record an exchange attempt between rung and rung + 1
+    void recordSwap(size_t rung, bool accepted);
+    double acceptanceRate(size_t rung) const;
+
+    // Rebalance the gaps from the exchange statistics gathered since the last call
+    void adapt();
+
+private:
+    std::vector<double> temperatures;
+    std::vector<size_t> attempts;
+    std::vector<size_t> accepts;
+};
+
+#endif // TEMPERATURE_LADDER_HPP
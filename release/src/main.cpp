@@ -1,14 +1,166 @@
 #include <iostream>
 #include <fstream>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
 #include "CellLibraryParser.hpp"
 #include "NetlistParser.hpp"
 #include "GateMapper.hpp"
 #include "NetlistWriter.hpp"
 #include "Optimizer.hpp"
+#include "EquivalenceChecker.hpp"
+#include "SwitchingActivity.hpp"
+
+// Parse an integer option value in [minimum, maximum]. std::stoul alone takes "-1" and wraps it to
+// the largest value, and ignores trailing characters; both are rejected here with the exceptions of
+// std::stoull, which main reports as an invalid value
+template <typename T>
+static T parseInteger(const std::string& text, T minimum, T maximum = std::numeric_limits<T>::max()) {
+    bool negative = !text.empty() && text[0] == '-';
+    size_t first = negative ? 1 : 0;
+    if (first >= text.size() || !std::isdigit(static_cast<unsigned char>(text[first]))) {
+        throw std::invalid_argument(text);
+    }
+    size_t end = 0;
+    bool inRange;
+    T value;
+    if (negative) {
+        long long parsed = std::stoll(text, &end);
+        inRange = static_cast<long long>(minimum) <= parsed && std::numeric_limits<T>::is_signed;
+        value = static_cast<T>(parsed);
+    } else {
+        unsigned long long parsed = std::stoull(text, &end);
+        inRange = parsed <= static_cast<unsigned long long>(maximum) &&
+                  (static_cast<long long>(minimum) <= 0 || parsed >= static_cast<unsigned long long>(minimum));
+        value = static_cast<T>(parsed);
+    }
+    if (end != text.size() || !inRange) {
+        throw std::out_of_range(text);
+    }
+    return value;
+}
+
+// Parse a real option value in [minimum, maximum], rejecting trailing characters and NaN
+static double parseReal(const std::string& text, double minimum, double maximum = std::numeric_limits<double>::max()) {
+    size_t end = 0;
+    double value = std::stod(text, &end);
+    if (end != text.size() || !(value >= minimum && value <= maximum)) {
+        throw std::out_of_range(text);
+    }
+    return value;
+}
+
+// Check the mapped netlist in outputFile against the input netlist; returns the exit code
+static int verifyOutput(const Netlist& netlist, const std::unordered_map<std::string, std::vector<std::string>>& gateMapping,
+                        const std::string& outputFile, const std::string& method, size_t patterns, size_t conflicts, uint64_t seed) {
+    // Map the cells of the written netlist back to their gate types
+    std::unordered_map<std::string, GateFunction> cellFunctions;
+    for (const auto& entry : gateMapping) {
+        for (const auto& cellName : entry.second) {
+            cellFunctions[cellName] = gateFunction(entry.first);
+        }
+    }
+    NetlistParser outputParser(outputFile, false);
+    outputParser.parse();
+    const Netlist& mapped = outputParser.getNetlist();
+    std::vector<GateFunction> functions;
+    for (const auto& gate : mapped.gates) {
+        auto it = cellFunctions.find(gate.type);
+        functions.push_back(it != cellFunctions.end() ? it->second : GATE_UNKNOWN);
+    }
+
+    EquivalenceChecker checker(netlist, mapped, functions);
+    Random random(seed != 0 ? seed : Random::timeSeed());
+    // Simulation finds most differences quickly; the proof then covers the patterns it did not try
+    EquivalenceResult result = checker.check(patterns, random);
+    if (result.equivalent && method == "sat") {
+        result = checker.prove(random, conflicts);
+    }
+    if (!result.error.empty()) {
+        std::cerr << "Error: Verification failed: " << result.error << std::endl;
+        return 1;
+    }
+    if (!result.equivalent) {
+        if (result.output.empty()) {
+            std::cerr << "Error: Verification incomplete: " << result.undecidedOutputs << " outputs undecided within the conflict limit"
+                      << std::endl;
+            return 1;
+        }
+        std::cerr << "Error: Verification failed: output " << result.output << " differs";
+        if (result.patterns > 0) {
+            std::cerr << " after " << result.patterns << " random patterns";
+        }
+        std::cerr << std::endl;
+        std::cerr << "Counterexample:";
+        for (const auto& input : result.counterexample) {
+            std::cerr << " " << input.first << "=" << input.second;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+    if (result.proved) {
+        std::cout << "Verification passed: proved equivalent with " << result.satCalls << " SAT calls, " << result.mergedNodes
+                  << " merged nodes" << std::endl;
+    } else {
+        std::cout << "Verification passed: " << result.patterns << " random patterns" << std::endl;
+    }
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc != 5) {
-        std::cerr << "Usage: " << argv[0] << " <netlist> <cell_library> <output> <cost_estimator>" << std::endl;
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <netlist> <cell_library> <output> <cost_estimator> [options]" << std::endl;
+        std::cerr << "The cost estimator may be builtin:mock[:<options>] to use the in-process mock estimator." << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --workers <K>      number of concurrent cost estimator workers, at least 1 (default 1)" << std::endl;
+        std::cerr << "  --scratch <dir>    scratch directory for worker files (default <output>.work)" << std::endl;
+        std::cerr << "  --pipeline <N>     speculative neighbors kept in flight (default one per worker)" << std::endl;
+        std::cerr << "  --revalidate <N>   re-measure the current mapping every N iterations (default off)" << std::endl;
+        std::cerr << "  --cache-size <N>   costs kept in the in-memory cache (default 100000, 0 disables)" << std::endl;
+        std::cerr << "  --cache-dir <dir>  keep a persistent cost cache per design/library/estimator in dir" << std::endl;
+        std::cerr << "  --disk-cache-size <N>  slots of the persistent cache's in-memory index (default 1000000)" << std::endl;
+        std::cerr << "  --metrics <file>   write estimator latency histograms as JSON" << std::endl;
+        std::cerr << "  --metrics-interval <s>  seconds between metrics reports (default 60)" << std::endl;
+        std::cerr << "  --surrogate <N>    screen N neighbors with a learned cost model per estimator call (default off)" << std::endl;
+        std::cerr << "  --surrogate-refit <N>  samples between surrogate model refits (default 50)" << std::endl;
+        std::cerr << "  --probe <N>        probe the estimator with N pair perturbations and use exact deltas if it is additive" << std::endl;
+        std::cerr << "  --engine <name>    search engine: sa (simulated annealing, default), pt (parallel tempering)," << std::endl;
+        std::cerr << "                     batch (batched moves), ga (genetic algorithm), tabu (tabu search) or cone" << std::endl;
+        std::cerr << "                     (output cone partitions optimized side by side, then refined together)" << std::endl;
+        std::cerr << "  --replicas <N>     parallel tempering replicas (default one per worker, at least 4)" << std::endl;
+        std::cerr << "  --swap-interval <N>  parallel tempering steps between replica exchanges (default 10)" << std::endl;
+        std::cerr << "  --batch-moves <N>  moves tested together per batch engine round (default 63)" << std::endl;
+        std::cerr << "  --batch-design <name>  batch engine experiment: hadamard (default) or random" << std::endl;
+        std::cerr << "  --population <N>   genetic engine population size (default 32)" << std::endl;
+        std::cerr << "  --elite <N>        genetic engine individuals kept per generation (default 2)" << std::endl;
+        std::cerr << "  --cone-depth <N>   levels of the fanin cones exchanged by crossover (default 4)" << std::endl;
+        std::cerr << "  --tabu-neighbors <N>  tabu engine neighbors evaluated per step (default 16)" << std::endl;
+        std::cerr << "  --tabu-tenure <N>  initial tabu tenure in steps, adapted during the run (default square root of the gate count)" << std::endl;
+        std::cerr << "  --partitions <N>   cone engine partitions (default one per worker, at least 2)" << std::endl;
+        std::cerr << "  --partition-share <f>  share of the budget the cone engine spends on the partitions (default 0.5)" << std::endl;
+        std::cerr << "  --cooling <name>   annealing schedule: adaptive (calibrated to the estimator, default) or fixed" << std::endl;
+        std::cerr << "  --initial-acceptance <p>  adaptive schedule: start so an average uphill move is accepted with p (default 0.8)" << std::endl;
+        std::cerr << "  --checkpoint <file>  save the annealer state to file periodically (sa engine only)" << std::endl;
+        std::cerr << "  --checkpoint-interval <s>  seconds between checkpoints (default 300)" << std::endl;
+        std::cerr << "  --resume           continue from the checkpoint file if it exists" << std::endl;
+        std::cerr << "  --seed <N>         random seed for a reproducible run (default from the clock, logged in optimizer.txt)" << std::endl;
+        std::cerr << "  --time-limit <s>   wall-clock limit (default 2 s per gate, between 10 minutes and 3 hours)" << std::endl;
+        std::cerr << "  --max-evals <N>    stop after N estimator evaluations (default unlimited)" << std::endl;
+        std::cerr << "  --stall <K>        stop after K evaluations without best-cost improvement (default off)" << std::endl;
+        std::cerr << "  --stall-epsilon <e>  relative improvement below which the run counts as stalled (default 0)" << std::endl;
+        std::cerr << "  --init <name>      starting mapping: first (first listed cell, default) or sweep (per-type sweep and descent)" << std::endl;
+        std::cerr << "  --sweep-rounds <N>  coordinate descent rounds of the sweep initialization (default 3)" << std::endl;
+        std::cerr << "  --moves <policy>   neighbor moves: single (default), or ucb/thompson to schedule move operators with a bandit" << std::endl;
+        std::cerr << "  --delay-attr <N>   cell attribute used as delay by the critical-path move (default: the mock" << std::endl;
+        std::cerr << "                     estimator's delay_attr, unit gate delays for external estimators)" << std::endl;
+        std::cerr << "  --prune <mode>     drop Pareto-dominated cells: off (default), pareto, or strict (verified by estimator probes)" << std::endl;
+        std::cerr << "  --activity <file>  write signal probabilities and toggle rates of the nets as JSON" << std::endl;
+        std::cerr << "  --activity-mode <name>  analytic (propagated, default) or sim (bit-parallel simulation of 65536 cycles)" << std::endl;
+        std::cerr << "  --verify           check the output netlist against the input, exit 1 unless they are equivalent" << std::endl;
+        std::cerr << "  --verify-only      only check an existing output netlist against the input, without optimizing" << std::endl;
+        std::cerr << "  --verify-method <name>  sat (random simulation, then a SAT sweeping proof, default) or sim (simulation only)" << std::endl;
+        std::cerr << "  --verify-patterns <N>  random patterns simulated by --verify (default 65536, 0 leaves it all to the proof)" << std::endl;
+        std::cerr << "  --verify-conflicts <N>  SAT conflicts per output before the proof gives up (default 0, no limit)" << std::endl;
         return 1;
     }
 
@@ -17,6 +169,162 @@ int main(int argc, char* argv[]) {
     std::string outputFile = argv[3];
     std::string costEstimator = argv[4];
 
+    // Parse the optional arguments
+    OptimizerConfig config;
+    std::string activityFile;
+    std::string activityMode = "analytic";
+    bool verify = false;
+    bool verifyOnly = false;
+    std::string verifyMethod = "sat";
+    size_t verifyPatterns = 65536;
+    size_t verifyConflicts = 0;
+    for (int i = 5; i < argc; ++i) {
+        std::string option = argv[i];
+        // The numeric parsers throw on malformed or out-of-range values
+        try {
+            if (option == "--workers" && i + 1 < argc) {
+                config.numWorkers = parseInteger<size_t>(argv[++i], 1);
+            } else if (option == "--scratch" && i + 1 < argc) {
+                config.scratchDir = argv[++i];
+            } else if (option == "--pipeline" && i + 1 < argc) {
+                config.pipelineDepth = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--revalidate" && i + 1 < argc) {
+                config.revalidateInterval = parseInteger<int>(argv[++i], 0);
+            } else if (option == "--cache-size" && i + 1 < argc) {
+                config.cacheCapacity = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--cache-dir" && i + 1 < argc) {
+                config.cacheDir = argv[++i];
+            } else if (option == "--disk-cache-size" && i + 1 < argc) {
+                config.diskCacheCapacity = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--metrics" && i + 1 < argc) {
+                config.metricsFile = argv[++i];
+            } else if (option == "--metrics-interval" && i + 1 < argc) {
+                config.metricsInterval = parseInteger<int>(argv[++i], 1);
+            } else if (option == "--surrogate" && i + 1 < argc) {
+                config.surrogateScreen = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--surrogate-refit" && i + 1 < argc) {
+                config.surrogateRefit = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--probe" && i + 1 < argc) {
+                config.probePairs = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--engine" && i + 1 < argc) {
+                config.engine = argv[++i];
+                if (config.engine != "sa" && config.engine != "pt" && config.engine != "batch" && config.engine != "ga" &&
+                    config.engine != "tabu" && config.engine != "cone") {
+                    std::cerr << "Error: Unknown engine " << config.engine << std::endl;
+                    return 1;
+                }
+            } else if (option == "--replicas" && i + 1 < argc) {
+                config.replicas = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--swap-interval" && i + 1 < argc) {
+                config.swapInterval = parseInteger<int>(argv[++i], 0);
+            } else if (option == "--batch-moves" && i + 1 < argc) {
+                config.batchMoves = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--population" && i + 1 < argc) {
+                config.populationSize = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--elite" && i + 1 < argc) {
+                config.eliteCount = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--cone-depth" && i + 1 < argc) {
+                config.coneDepth = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--tabu-neighbors" && i + 1 < argc) {
+                config.tabuNeighbors = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--tabu-tenure" && i + 1 < argc) {
+                config.tabuTenure = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--partitions" && i + 1 < argc) {
+                config.partitions = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--partition-share" && i + 1 < argc) {
+                config.partitionShare = parseReal(argv[++i], std::numeric_limits<double>::min(), 1.0);
+            } else if (option == "--cooling" && i + 1 < argc) {
+                config.cooling = argv[++i];
+                if (config.cooling != "adaptive" && config.cooling != "fixed") {
+                    std::cerr << "Error: Unknown cooling schedule " << config.cooling << std::endl;
+                    return 1;
+                }
+            } else if (option == "--initial-acceptance" && i + 1 < argc) {
+                config.initialAcceptance = parseReal(argv[++i], 0.0, 1.0);
+            } else if (option == "--checkpoint" && i + 1 < argc) {
+                config.checkpointFile = argv[++i];
+            } else if (option == "--checkpoint-interval" && i + 1 < argc) {
+                config.checkpointInterval = parseInteger<int>(argv[++i], 0);
+            } else if (option == "--resume") {
+                config.resume = true;
+            } else if (option == "--batch-design" && i + 1 < argc) {
+                config.batchDesign = argv[++i];
+                if (config.batchDesign != "hadamard" && config.batchDesign != "random") {
+                    std::cerr << "Error: Unknown batch design " << config.batchDesign << std::endl;
+                    return 1;
+                }
+            } else if (option == "--seed" && i + 1 < argc) {
+                config.seed = parseInteger<uint64_t>(argv[++i], 0);
+            } else if (option == "--time-limit" && i + 1 < argc) {
+                config.timeLimit = parseReal(argv[++i], 0.0);
+            } else if (option == "--max-evals" && i + 1 < argc) {
+                config.maxEvaluations = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--stall" && i + 1 < argc) {
+                config.stallEvaluations = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--stall-epsilon" && i + 1 < argc) {
+                config.stallEpsilon = parseReal(argv[++i], 0.0);
+            } else if (option == "--init" && i + 1 < argc) {
+                config.initialization = argv[++i];
+                if (config.initialization != "first" && config.initialization != "sweep") {
+                    std::cerr << "Error: Unknown initialization " << config.initialization << std::endl;
+                    return 1;
+                }
+            } else if (option == "--sweep-rounds" && i + 1 < argc) {
+                config.sweepRounds = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--moves" && i + 1 < argc) {
+                config.movePolicy = argv[++i];
+                if (config.movePolicy != "single" && config.movePolicy != "ucb" && config.movePolicy != "thompson") {
+                    std::cerr << "Error: Unknown move policy " << config.movePolicy << std::endl;
+                    return 1;
+                }
+            } else if (option == "--delay-attr" && i + 1 < argc) {
+                config.delayAttribute = parseInteger<int>(argv[++i], -1);
+            } else if (option == "--prune" && i + 1 < argc) {
+                config.cellPruning = argv[++i];
+                if (config.cellPruning != "off" && config.cellPruning != "pareto" && config.cellPruning != "strict") {
+                    std::cerr << "Error: Unknown pruning mode " << config.cellPruning << std::endl;
+                    return 1;
+                }
+            } else if (option == "--activity" && i + 1 < argc) {
+                activityFile = argv[++i];
+            } else if (option == "--activity-mode" && i + 1 < argc) {
+                activityMode = argv[++i];
+                if (activityMode != "analytic" && activityMode != "sim") {
+                    std::cerr << "Error: Unknown activity mode " << activityMode << std::endl;
+                    return 1;
+                }
+            } else if (option == "--verify") {
+                verify = true;
+            } else if (option == "--verify-only") {
+                verifyOnly = true;
+            } else if (option == "--verify-method" && i + 1 < argc) {
+                verifyMethod = argv[++i];
+                if (verifyMethod != "sat" && verifyMethod != "sim") {
+                    std::cerr << "Error: Unknown verification method " << verifyMethod << std::endl;
+                    return 1;
+                }
+            } else if (option == "--verify-patterns" && i + 1 < argc) {
+                verifyPatterns = parseInteger<size_t>(argv[++i], 0);
+            } else if (option == "--verify-conflicts" && i + 1 < argc) {
+                verifyConflicts = parseInteger<size_t>(argv[++i], 0);
+            } else {
+                std::cerr << "Unknown or incomplete option: " << option << std::endl;
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Invalid value for option " << option << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if ((!config.checkpointFile.empty() || config.resume) && config.engine != "sa") {
+        std::cerr << "Error: Checkpoints are only supported by the sa engine" << std::endl;
+        return 1;
+    }
+    if (config.resume && config.checkpointFile.empty()) {
+        std::cerr << "Error: --resume needs --checkpoint <file>" << std::endl;
+        return 1;
+    }
+
     // Parse the cell library
     CellLibraryParser cellLibraryParser(cellLibraryFile);
     cellLibraryParser.parse();
@@ -26,8 +334,12 @@ int main(int argc, char* argv[]) {
     GateMapper gateMapper(cells);
     std::unordered_map<std::string, std::vector<std::string>> gateMapping = gateMapper.createGateMapping();
 
-    // Parse the netlist
+    // Parse the netlist; an existing output is only checked, not overwritten
     NetlistParser netlistParser(netlistFile);
+    if (verifyOnly) {
+        netlistParser.parse();
+        return verifyOutput(netlistParser.getNetlist(), gateMapping, outputFile, verifyMethod, verifyPatterns, verifyConflicts, config.seed);
+    }
     netlistParser.parse(outputFile);
     const Netlist& netlist = netlistParser.getNetlist();
 
@@ -46,9 +358,35 @@ int main(int argc, char* argv[]) {
     NetlistWriter netlistWriter;
     netlistWriter.writeNetlist(netlist, gateToCellMapping, outputFile);
 
+    // Switching activity depends on the gate functions only, so the input netlist is enough
+    if (!activityFile.empty()) {
+        SwitchingActivity activity(netlist);
+        if (!activity.error().empty()) {
+            std::cerr << "Error: Switching activity: " << activity.error() << std::endl;
+            return 1;
+        }
+        if (activityMode == "sim") {
+            Random random(config.seed != 0 ? config.seed : Random::timeSeed());
+            activity.simulate(random, 65536, 0.5);
+        } else {
+            activity.propagate(0.5);
+        }
+        if (!activity.writeJson(activityFile, activityMode)) {
+            return 1;
+        }
+    }
+
     // Optimize the netlist
-    Optimizer optimizer(netlist, gateMapping, cellLibraryFile, outputFile, costEstimator);
+    Optimizer optimizer(netlist, gateMapping, cells, cellLibraryFile, outputFile, costEstimator, config);
     optimizer.optimize();
+    if (optimizer.failed()) {
+        std::cerr << "Error: The search failed, the output netlist is not optimized" << std::endl;
+        return 1;
+    }
+
+    if (verify) {
+        return verifyOutput(netlist, gateMapping, outputFile, verifyMethod, verifyPatterns, verifyConflicts, config.seed);
+    }
 
     return 0;
 }
@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "CellLibraryParser.hpp"
+#include "NetlistParser.hpp"
+#include "MockCostEstimator.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string libraryFile;
+    std::string netlistFile;
+    std::string outputFile;
+    MockCostConfig config;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "-library") {
+            libraryFile = value;
+        } else if (option == "-netlist") {
+            netlistFile = value;
+        } else if (option == "-output") {
+            outputFile = value;
+        } else if (option.size() < 2 || option[0] != '-' || !config.set(option.substr(1), value)) {
+            outputFile.clear();
+            break;
+        }
+    }
+
+    if (libraryFile.empty() || netlistFile.empty() || outputFile.empty()) {
+        std::cerr << "Usage: " << argv[0] << " -library <cell_library> -netlist <netlist> -output <cost_file> [options]" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  -weights <w1,w2,...>  weight per float cell attribute (default 1)" << std::endl;
+        std::cerr << "  -delay_weight <w>     weight of the longest path delay (default 1)" << std::endl;
+        std::cerr << "  -delay_attr <k>       float attribute used as cell delay (default 1)" << std::endl;
+        std::cerr << "  -power_weight <w>     weight of the activity-weighted switching power (default 0)" << std::endl;
+        std::cerr << "  -power_attr <k>       float attribute used as cell switching energy (default 3)" << std::endl;
+        std::cerr << "  -latency <ms>         artificial runtime per evaluation (default 0)" << std::endl;
+        return 1;
+    }
+
+    CellLibraryParser cellLibraryParser(libraryFile);
+    cellLibraryParser.parse();
+
+    // Mapped netlists list the gate output last
+    NetlistParser netlistParser(netlistFile, false);
+    netlistParser.parse();
+
+    MockCostEstimator estimator(cellLibraryParser.getCells(), config);
+    float cost = estimator.estimate(netlistParser.getNetlist());
+
+    char line[64];
+    std::snprintf(line, sizeof(line), "cost = %f", cost);
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open output file " << outputFile << std::endl;
+        return 1;
+    }
+    out << line << std::endl;
+    std::cout << line << std::endl;
+    return 0;
+}